@@ -0,0 +1,295 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "bench/benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <experimental/filesystem>
+#include "event/replay/replay_event_handler.hpp"
+#include "puzzle/puzzle.hpp"
+#include "utility/profiler.hpp"
+#include "view/puzzle_view.hpp"
+#include "view/view_manager.hpp"
+
+namespace stdfs = std::experimental::filesystem;
+
+constexpr unsigned frame_ticks = 16;
+
+Benchmark::Benchmark(const Options& options)
+  : m_options(options)
+{
+  m_view_mgr = std::make_unique<ViewManager>(m_video, m_renderer,
+                                             m_settings,
+                                             m_options.width,
+                                             m_options.height);
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+std::vector<Benchmark::Result> Benchmark::run()
+{
+  std::vector<Result> results;
+  for (int size : m_options.sizes)
+    run_puzzle(size, results);
+  if (m_options.file_view)
+    run_file_view(results);
+  for (const auto& filename : m_options.replays)
+    run_replay(filename, results);
+  return results;
+}
+
+void Benchmark::run_puzzle(int size, std::vector<Result>& results)
+{
+  std::string filename = make_puzzle(size);
+
+  //loading is timed on its own, it is not a frame
+  auto start = std::chrono::steady_clock::now();
+  auto view = std::make_shared<PuzzleView>(*m_view_mgr, filename,
+                                           m_options.width,
+                                           m_options.height);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  Result load;
+  load.scenario = "load";
+  load.size = size;
+  load.frames = 1;
+  load.avg_time = load.max_time
+    = std::chrono::duration<double, std::milli>(elapsed).count();
+  results.push_back(load);
+
+  m_view_mgr->push(view);
+
+  //the puzzle is centered to the right of the info pane
+  int center_x = PuzzleView::info_pane_width
+    + (m_options.width - PuzzleView::info_pane_width) / 2;
+  int center_y = m_options.height / 2;
+
+  //let the info pane finish sliding in
+  results.push_back(run_frames("idle", size, 60, nullptr));
+
+  results.push_back(run_frames("zoom", size, 40,
+    [=](InputHandler& input, int frame) {
+      if (frame == 0)
+        input.process_mouse_move_event(center_x, center_y);
+      input.process_mouse_wheel_event(frame < 20 ? 1 : -1, 0);
+    }));
+
+  const int drag_frames = 60;
+  results.push_back(run_frames("paint", size, drag_frames,
+    [=](InputHandler& input, int frame) {
+      input.process_mouse_move_event(center_x + 3 * frame,
+                                     center_y + frame);
+      if (frame == 0)
+        input.process_mouse_button_event(Mouse::Button::left, true);
+      else if (frame == drag_frames - 1)
+        input.process_mouse_button_event(Mouse::Button::left, false);
+    }));
+
+  results.push_back(run_frames("scroll", size, drag_frames,
+    [=](InputHandler& input, int frame) {
+      input.process_mouse_move_event(center_x - 6 * frame,
+                                     center_y - 3 * frame);
+      if (frame == 0)
+        input.process_mouse_button_event(Mouse::Button::middle, true);
+      else if (frame == drag_frames - 1)
+        input.process_mouse_button_event(Mouse::Button::middle, false);
+    }));
+
+  results.push_back(run_frames("keyboard", size, 40,
+    [](InputHandler& input, int frame) {
+      input.process_key_event(Keyboard::Key::right, frame % 2 == 0);
+      if (frame % 10 == 4)
+        input.process_key_event(Keyboard::Key::space, true);
+      else if (frame % 10 == 5)
+        input.process_key_event(Keyboard::Key::space, false);
+    }));
+
+  m_view_mgr->pop();
+
+  std::error_code ec;
+  stdfs::remove(filename, ec);
+}
+
+void Benchmark::run_file_view(std::vector<Result>& results)
+{
+  m_view_mgr->schedule_action(ViewManager::Action::choose_puzzle);
+
+  int center_x = m_options.width / 2;
+  int center_y = m_options.height / 2;
+  results.push_back(run_frames("file_list", 0, 120,
+    [=](InputHandler& input, int frame) {
+      if (frame == 0)
+        input.process_mouse_move_event(center_x, center_y);
+      else if (frame >= 20)
+        input.process_mouse_wheel_event(-1, 0);
+    }));
+
+  m_view_mgr->pop();
+}
+
+void Benchmark::run_replay(const std::string& filename,
+                           std::vector<Result>& results)
+{
+  ReplayEventHandler replay(filename);
+  m_view_mgr->resize(replay.width(), replay.height());
+  m_view_mgr->schedule_action(ViewManager::Action::open_menu);
+
+  //one more frame than recorded so that the final quit is handled
+  std::string name = stdfs::path(filename).stem().string();
+  int frames = static_cast<int>(replay.num_frames()) + 1;
+  results.push_back(run_frames(name, 0, frames, nullptr, &replay));
+
+  m_view_mgr->schedule_action(ViewManager::Action::force_quit);
+  m_view_mgr->update(0, m_input);
+  m_view_mgr->resize(m_options.width, m_options.height);
+}
+
+Benchmark::Result Benchmark::run_frames(const std::string& scenario,
+                                        int size, int frames,
+                                        const Script& script,
+                                        EventHandler* events)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  Result result;
+  result.scenario = scenario;
+  result.size = size;
+  result.frames = frames;
+
+  Profiler& profiler = Profiler::instance();
+  profiler.set_enabled(true);
+  m_renderer.reset_stats();
+
+  //the profiler only keeps its most recent frames, so the section
+  //times are totalled as each frame ends
+  int update = static_cast<int>(Profiler::Section::view_update);
+  int draw = static_cast<int>(Profiler::Section::view_draw);
+
+  std::size_t prev_ticks = events ? events->get_ticks() : 0;
+  std::clock_t cpu_start = std::clock();
+  for (int frame = 0; frame < frames; ++frame) {
+    auto start = Clock::now();
+    profiler.begin_frame();
+
+    unsigned elapsed = frame_ticks;
+    if (events) {
+      std::size_t ticks = events->get_ticks();
+      elapsed = ticks - prev_ticks;
+      prev_ticks = ticks;
+    }
+
+    m_input.update(elapsed);
+    if (script)
+      script(m_input, frame);
+    if (events)
+      events->process(m_input, *m_view_mgr);
+
+    m_renderer.clear();
+    m_view_mgr->update(elapsed, m_input);
+    m_view_mgr->draw(m_renderer);
+    m_renderer.present();
+
+    profiler.end_frame();
+    const auto& fr = profiler.frame(profiler.num_frames() - 1);
+    result.update_time += fr.section_time[update] / 1000.0;
+    result.draw_time += fr.section_time[draw] / 1000.0;
+
+    double time
+      = std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+    result.avg_time += time;
+    result.max_time = std::max(result.max_time, time);
+
+    if (events && m_view_mgr->empty()) {
+      frames = result.frames = frame + 1;
+      break;
+    }
+  }
+  result.cpu_time = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  profiler.set_enabled(false);
+
+  if (frames > 0) {
+    result.avg_time /= frames;
+    result.cpu_time /= frames;
+    result.update_time /= frames;
+    result.draw_time /= frames;
+  }
+  result.stats = m_renderer.stats();
+  return result;
+}
+
+std::string Benchmark::make_puzzle(int size) const
+{
+  //a fixed seed keeps runs comparable
+  std::mt19937 rng(size);
+  std::bernoulli_distribution filled(0.5);
+
+  Puzzle puzzle(size, size);
+  for (int y = 0; y < size; ++y)
+    for (int x = 0; x < size; ++x)
+      if (filled(rng))
+        puzzle.mark_cell(x, y);
+  puzzle.update(true);
+  puzzle.set_property("title", "Benchmark " + std::to_string(size));
+
+  stdfs::path path = stdfs::temp_directory_path()
+    / ("nonny-bench-" + std::to_string(size) + ".non");
+  std::ofstream file(path.string());
+  if (!file.is_open())
+    throw std::runtime_error("Benchmark::make_puzzle: could not write "
+                             + path.string());
+  write_puzzle(file, puzzle, PuzzleFormat::non);
+  return path.string();
+}
+
+void print_results(std::ostream& os,
+                   const std::vector<Benchmark::Result>& results)
+{
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "%-10s %5s %6s %9s %9s %9s %9s %9s %8s %9s %7s %10s\n",
+                "scenario", "size", "frames", "avg ms", "max ms", "cpu ms",
+                "update ms", "draw ms", "draws", "prims", "texts",
+                "upload KB");
+  os << line;
+
+  for (const auto& r : results) {
+    double frames = std::max(r.frames, 1);
+    std::snprintf(line, sizeof(line),
+                  "%-10s %5d %6d %9.3f %9.3f %9.3f %9.3f %9.3f %8.1f %9.1f"
+                  " %7.1f %10.1f\n",
+                  r.scenario.c_str(), r.size, r.frames,
+                  r.avg_time, r.max_time, r.cpu_time,
+                  r.update_time, r.draw_time,
+                  r.stats.draw_calls / frames,
+                  r.stats.primitives / frames,
+                  r.stats.text_draws / frames,
+                  r.stats.bytes_uploaded / frames / 1024.0);
+    os << line;
+  }
+}
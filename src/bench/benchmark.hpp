@@ -0,0 +1,100 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_BENCHMARK_HPP
+#define NONNY_BENCHMARK_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "input/null/null_input_handler.hpp"
+#include "settings/game_settings.hpp"
+#include "video/null/null_renderer.hpp"
+#include "video/null/null_video_system.hpp"
+
+class EventHandler;
+class ViewManager;
+
+/*
+ * Runs the interface offscreen and measures it. Each scenario feeds
+ * scripted input to a view for a number of frames, recording the time
+ * taken per frame and what the view asked the renderer to do. Puzzle
+ * scenarios are repeated for randomly generated puzzles of each size.
+ * Input recordings can also be played back at full speed, starting
+ * from the main menu as the game does.
+ */
+class Benchmark {
+public:
+  struct Options {
+    std::vector<int> sizes { 25, 50, 100, 200, 400, 800 };
+    int width = 1280;
+    int height = 720;
+    bool file_view = true; //also scroll through the puzzle directory
+    std::vector<std::string> replays; //input recordings to play back
+  };
+
+  // Times are in milliseconds per frame, statistics are totals
+  struct Result {
+    std::string scenario;
+    int size = 0;
+    int frames = 0;
+    double avg_time = 0;
+    double max_time = 0;
+    double cpu_time = 0;
+    double update_time = 0;
+    double draw_time = 0;
+    NullRenderer::Stats stats;
+  };
+
+  // Called before each frame with the frame number
+  typedef std::function<void(InputHandler&, int)> Script;
+
+  explicit Benchmark(const Options& options);
+  ~Benchmark();
+
+  std::vector<Result> run();
+
+private:
+  void run_puzzle(int size, std::vector<Result>& results);
+  void run_file_view(std::vector<Result>& results);
+  void run_replay(const std::string& filename, std::vector<Result>& results);
+
+  // If events is given, it supplies the input and frame times, and
+  // the run ends early if the views are closed
+  Result run_frames(const std::string& scenario, int size,
+                    int frames, const Script& script,
+                    EventHandler* events = nullptr);
+  std::string make_puzzle(int size) const;
+
+  Options m_options;
+  GameSettings m_settings;
+  NullVideoSystem m_video;
+  NullRenderer m_renderer;
+  NullInputHandler m_input;
+  std::unique_ptr<ViewManager> m_view_mgr;
+};
+
+// Print results as an aligned table, with statistics per frame
+void print_results(std::ostream& os,
+                   const std::vector<Benchmark::Result>& results);
+
+#endif
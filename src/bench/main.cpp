@@ -0,0 +1,92 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "bench/benchmark.hpp"
+#include "utility/utility.hpp"
+
+void print_usage(const char* program)
+{
+  std::cout << "Usage: " << program << " [OPTION]... [SIZE]...\n"
+            << "Run the interface offscreen on generated puzzles of each\n"
+            << "SIZE (default 25 50 100 200 400 800) and report frame\n"
+            << "times and renderer statistics.\n\n"
+            << "  -W, --width N     window width (default 1280)\n"
+            << "  -H, --height N    window height (default 720)\n"
+            << "  -n, --no-files    skip the file selection scenario\n"
+            << "  -r, --replay FILE play back an input recording made with\n"
+            << "                    nonny --record; only recordings are run\n"
+            << "                    unless sizes are also given\n"
+            << "  -h, --help        display this help and exit\n";
+}
+
+int main(int argc, char* argv[])
+{
+  Benchmark::Options options;
+  std::vector<int> sizes;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg == "-h" || arg == "--help") {
+        print_usage(argv[0]);
+        return 0;
+      } else if (arg == "-n" || arg == "--no-files") {
+        options.file_view = false;
+      } else if ((arg == "-r" || arg == "--replay") && i + 1 < argc) {
+        options.replays.push_back(argv[++i]);
+      } else if ((arg == "-W" || arg == "--width") && i + 1 < argc) {
+        options.width = str_to_uint(argv[++i]);
+      } else if ((arg == "-H" || arg == "--height") && i + 1 < argc) {
+        options.height = str_to_uint(argv[++i]);
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unrecognized option " + arg);
+      } else {
+        int size = str_to_uint(arg);
+        if (size <= 0)
+          throw std::invalid_argument("invalid puzzle size " + arg);
+        sizes.push_back(size);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    print_usage(argv[0]);
+    return 2;
+  }
+
+  if (!sizes.empty()) {
+    options.sizes = sizes;
+  } else if (!options.replays.empty()) {
+    options.sizes.clear();
+    options.file_view = false;
+  }
+
+  try {
+    Benchmark bench(options);
+    print_results(std::cout, bench.run());
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "color/color_quantizer.hpp"
+
+#include <algorithm>
+
+constexpr int num_bins = 1 << 15;
+
+ColorQuantizer::ColorQuantizer(int max_colors)
+  : m_max_colors(std::max(max_colors, 1)),
+    m_bins(num_bins),
+    m_bin_color(num_bins, 0)
+{
+}
+
+void ColorQuantizer::add(int red, int green, int blue)
+{
+  Bin& bin = m_bins[bin_index(red, green, blue)];
+  ++bin.count;
+  bin.red += red;
+  bin.green += green;
+  bin.blue += blue;
+
+  if (!m_too_many_colors) {
+    m_exact.emplace(pack(red, green, blue), 0);
+    if (static_cast<int>(m_exact.size()) > m_max_colors) {
+      m_too_many_colors = true;
+      m_exact.clear();
+    }
+  }
+}
+
+void ColorQuantizer::build()
+{
+  m_palette.clear();
+
+  if (m_too_many_colors) {
+    median_cut();
+    return;
+  }
+
+  //few enough colors to keep them all, in a predictable order
+  std::vector<std::uint32_t> colors;
+  for (const auto& entry : m_exact)
+    colors.push_back(entry.first);
+  std::sort(colors.begin(), colors.end());
+
+  for (auto c : colors) {
+    m_exact[c] = m_palette.size();
+    m_palette.push_back(Color(c >> 16 & 0xff, c >> 8 & 0xff, c & 0xff));
+  }
+}
+
+/*
+ * Repeatedly split the box of histogram bins with the widest channel
+ * range at the median pixel along that channel. Each final box
+ * becomes the average color of the pixels it contains.
+ */
+void ColorQuantizer::median_cut()
+{
+  struct Box {
+    std::size_t begin, end;
+    int channel;
+    int range;
+  };
+
+  auto channel_value = [](int bin, int channel) {
+    return bin >> (5 * (2 - channel)) & 0x1f;
+  };
+
+  std::vector<int> bins;
+  for (int i = 0; i < num_bins; ++i)
+    if (m_bins[i].count)
+      bins.push_back(i);
+
+  auto measure = [&](Box& box) {
+    int lo[3] = { 31, 31, 31 }, hi[3] = { 0, 0, 0 };
+    for (std::size_t i = box.begin; i != box.end; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        lo[c] = std::min(lo[c], channel_value(bins[i], c));
+        hi[c] = std::max(hi[c], channel_value(bins[i], c));
+      }
+    }
+    box.channel = 0;
+    for (int c = 1; c < 3; ++c)
+      if (hi[c] - lo[c] > hi[box.channel] - lo[box.channel])
+        box.channel = c;
+    box.range = hi[box.channel] - lo[box.channel];
+  };
+
+  std::vector<Box> boxes;
+  if (!bins.empty()) {
+    boxes.push_back({ 0, bins.size(), 0, 0 });
+    measure(boxes.back());
+  }
+
+  while (static_cast<int>(boxes.size()) < m_max_colors) {
+    auto it = std::max_element(boxes.begin(), boxes.end(),
+                               [](const Box& l, const Box& r)
+                               { return l.range < r.range; });
+    if (it == boxes.end() || it->range == 0)
+      break;
+
+    Box box = *it;
+    std::sort(bins.begin() + box.begin, bins.begin() + box.end,
+              [&](int l, int r) { return channel_value(l, box.channel)
+                                    < channel_value(r, box.channel); });
+
+    std::uint64_t total = 0, half = 0;
+    for (std::size_t i = box.begin; i != box.end; ++i)
+      total += m_bins[bins[i]].count;
+
+    std::size_t split = box.begin;
+    while (split + 1 < box.end && half + m_bins[bins[split]].count <= total / 2)
+      half += m_bins[bins[split++]].count;
+    if (split == box.begin)
+      ++split;
+
+    Box lower = { box.begin, split, 0, 0 };
+    Box upper = { split, box.end, 0, 0 };
+    measure(lower);
+    measure(upper);
+    *it = lower;
+    boxes.push_back(upper);
+  }
+
+  for (const auto& box : boxes) {
+    std::uint64_t count = 0, red = 0, green = 0, blue = 0;
+    for (std::size_t i = box.begin; i != box.end; ++i) {
+      const Bin& bin = m_bins[bins[i]];
+      count += bin.count;
+      red += bin.red;
+      green += bin.green;
+      blue += bin.blue;
+      m_bin_color[bins[i]] = m_palette.size();
+    }
+    m_palette.push_back(Color(static_cast<int>(red / count),
+                              static_cast<int>(green / count),
+                              static_cast<int>(blue / count)));
+  }
+}
@@ -0,0 +1,85 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_COLOR_QUANTIZER_HPP
+#define NONNY_COLOR_QUANTIZER_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "color/color.hpp"
+
+/*
+ * Reduces the colors of an image to a small palette. Colors are
+ * collected into a histogram with 5 bits per channel and the palette
+ * is chosen by median cut over the histogram, so the cost of building
+ * the palette does not depend on the number of pixels. If the image
+ * has no more distinct colors than allowed, they are kept exactly.
+ */
+class ColorQuantizer {
+public:
+  explicit ColorQuantizer(int max_colors);
+
+  // Count one pixel of the given color
+  void add(int red, int green, int blue);
+
+  // Choose the palette; must be called before map
+  void build();
+
+  const std::vector<Color>& palette() const { return m_palette; }
+
+  // Return the index of the palette color representing the given color
+  inline int map(int red, int green, int blue) const;
+
+private:
+  struct Bin {
+    std::uint32_t count = 0;
+    std::uint64_t red = 0, green = 0, blue = 0;
+  };
+
+  void median_cut();
+
+  static int bin_index(int red, int green, int blue)
+  { return (red >> 3) << 10 | (green >> 3) << 5 | (blue >> 3); }
+  static std::uint32_t pack(int red, int green, int blue)
+  { return red << 16 | green << 8 | blue; }
+
+  int m_max_colors;
+  std::vector<Bin> m_bins;
+  std::vector<int> m_bin_color;
+
+  //exact colors, abandoned once there are too many
+  std::unordered_map<std::uint32_t, int> m_exact;
+  bool m_too_many_colors = false;
+
+  std::vector<Color> m_palette;
+};
+
+
+/* implementation */
+
+inline int ColorQuantizer::map(int red, int green, int blue) const
+{
+  if (!m_too_many_colors)
+    return m_exact.at(pack(red, green, blue));
+  return m_bin_color[bin_index(red, green, blue)];
+}
+
+#endif
@@ -0,0 +1,282 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "convert/converter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include "puzzle/puzzle.hpp"
+#include "utility/utility.hpp"
+
+namespace stdfs = std::experimental::filesystem;
+
+namespace {
+  std::ios::openmode file_mode(PuzzleFormat format)
+  {
+    return format == PuzzleFormat::nbn ? std::ios::binary
+                                       : std::ios::openmode();
+  }
+
+  bool same_clues(const Puzzle::ClueContainer& l,
+                  const Puzzle::ClueContainer& r)
+  {
+    if (l.size() != r.size())
+      return false;
+
+    for (std::size_t i = 0; i != l.size(); ++i) {
+      if (l[i].size() != r[i].size())
+        return false;
+      for (std::size_t j = 0; j != l[i].size(); ++j) {
+        if (l[i][j].value != r[i][j].value
+            || l[i][j].color != r[i][j].color)
+          return false;
+      }
+    }
+    return true;
+  }
+}
+
+void Converter::run(const std::string& source, const std::string& dest)
+{
+  m_jobs.clear();
+  m_failures.clear();
+  m_source_pack = PuzzlePack();
+  m_num_converted = m_num_skipped = 0;
+
+  Path src(source), dst(dest);
+  if (!stdfs::exists(src))
+    throw std::runtime_error("Converter::run: " + source
+                             + " does not exist");
+
+  //in pack mode, destinations are only used to name the entries
+  Path dest_root = m_options.pack ? Path() : dst;
+  if (stdfs::is_directory(src))
+    collect_jobs(src, dest_root);
+  else if (is_pack_file(source))
+    collect_pack_jobs(src, dest_root);
+  else
+    add_job(src, dest_root);
+
+  //directories are created up front so workers never race on them
+  if (m_options.pack) {
+    Path dir = dst.parent_path();
+    if (!dir.empty() && !stdfs::exists(dir))
+      stdfs::create_directories(dir);
+    m_dest_pack.open(dest, true);
+  } else {
+    for (const auto& job : m_jobs) {
+      Path dir = job.dest.parent_path();
+      if (!dir.empty() && !stdfs::exists(dir))
+        stdfs::create_directories(dir);
+    }
+  }
+
+  int num_threads = m_options.jobs;
+  if (num_threads <= 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  num_threads = std::min<int>(num_threads, m_jobs.size());
+
+  std::atomic<std::size_t> next_job(0);
+  std::atomic<int> num_converted(0);
+  auto worker = [&]() {
+    std::size_t index;
+    while ((index = next_job++) < m_jobs.size()) {
+      try {
+        convert(m_jobs[index]);
+        ++num_converted;
+      } catch (const std::exception& e) {
+        const Job& job = m_jobs[index];
+        Path path = job.source;
+        if (job.entry)
+          path /= job.entry->name;
+        report_failure(path, e.what());
+
+        //don't leave partial output behind
+        if (!m_options.pack) {
+          std::error_code ec;
+          stdfs::remove(job.dest, ec);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& t : threads)
+    t.join();
+
+  //the whole pack is written at once, with a single table of contents
+  if (m_options.pack)
+    m_dest_pack.commit();
+
+  m_num_converted = num_converted;
+  std::sort(m_failures.begin(), m_failures.end(),
+            [](const Failure& l, const Failure& r)
+            { return l.path < r.path; });
+}
+
+void Converter::collect_jobs(const Path& source, const Path& dest)
+{
+  for (const auto& entry : stdfs::directory_iterator(source)) {
+    if (stdfs::is_directory(entry.status()))
+      collect_jobs(entry.path(), dest / entry.path().filename());
+    else
+      add_job(entry.path(), dest);
+  }
+}
+
+void Converter::collect_pack_jobs(const Path& source, const Path& dest)
+{
+  m_source_pack.open(source.string());
+  for (const auto& entry : m_source_pack) {
+    Job job;
+    job.source = source;
+    job.source_format = entry.format;
+    job.entry = &entry;
+    job.dest = dest / entry.name;
+    job.dest.replace_extension(puzzle_format_extension(m_options.format));
+    m_jobs.push_back(std::move(job));
+  }
+}
+
+void Converter::add_job(const Path& source, const Path& dest_dir)
+{
+  Job job;
+  if (!parse_puzzle_format(source.extension().string(), job.source_format)) {
+    ++m_num_skipped;
+    return;
+  }
+
+  job.source = source;
+  job.dest = dest_dir / source.filename();
+  job.dest.replace_extension(puzzle_format_extension(m_options.format));
+  m_jobs.push_back(std::move(job));
+}
+
+void Converter::convert(const Job& job)
+{
+  Puzzle puzzle;
+  read_source(job, puzzle);
+
+  if (puzzle.width() == 0 || puzzle.height() == 0)
+    throw InvalidPuzzleFile("puzzle has a size of 0");
+
+  if (m_options.pack) {
+    //entry names cannot contain directories, so flatten the path
+    std::string name;
+    for (const auto& part : job.dest) {
+      if (!name.empty())
+        name += '-';
+      name += part.string();
+    }
+
+    std::lock_guard<std::mutex> lock(m_pack_mutex);
+    m_dest_pack.append(name, puzzle, m_options.format);
+    return;
+  }
+
+  {
+    std::ofstream file(job.dest, std::ios::out
+                       | file_mode(m_options.format));
+    if (!file.is_open())
+      throw std::runtime_error("could not write to " + job.dest.string());
+    write_puzzle(file, puzzle, m_options.format);
+    if (!file)
+      throw std::runtime_error("could not write to " + job.dest.string());
+  }
+
+  if (m_options.verify) {
+    Puzzle copy;
+    std::ifstream file(job.dest, std::ios::in | file_mode(m_options.format));
+    read_puzzle(file, copy, m_options.format);
+
+    if (copy.width() != puzzle.width() || copy.height() != puzzle.height()
+        || !same_clues(copy.row_clues(), puzzle.row_clues())
+        || !same_clues(copy.col_clues(), puzzle.col_clues()))
+      throw std::runtime_error("verification failed: clues in "
+                               + job.dest.string() + " do not match");
+  }
+}
+
+void Converter::read_source(const Job& job, Puzzle& puzzle) const
+{
+  if (job.entry) {
+    m_source_pack.read(*job.entry, puzzle);
+    return;
+  }
+
+  std::ifstream file(job.source, std::ios::in
+                     | file_mode(job.source_format));
+  if (!file.is_open())
+    throw std::runtime_error("could not open file");
+  read_puzzle(file, puzzle, job.source_format);
+}
+
+void Converter::report_failure(const Path& path, const std::string& message)
+{
+  std::lock_guard<std::mutex> lock(m_failure_mutex);
+  m_failures.push_back({ path.string(), message });
+}
+
+bool parse_puzzle_format(std::string name, PuzzleFormat& format)
+{
+  std::transform(name.begin(), name.end(), name.begin(), to_lower);
+  if (!name.empty() && name[0] == '.')
+    name.erase(0, 1);
+
+  if (name == "non")
+    format = PuzzleFormat::non;
+  else if (name == "g")
+    format = PuzzleFormat::g;
+  else if (name == "mk")
+    format = PuzzleFormat::mk;
+  else if (name == "nin")
+    format = PuzzleFormat::nin;
+  else if (name == "nbn")
+    format = PuzzleFormat::nbn;
+  else
+    return false;
+  return true;
+}
+
+std::string puzzle_format_extension(PuzzleFormat format)
+{
+  switch (format) {
+  default:
+  case PuzzleFormat::non:
+    return ".non";
+  case PuzzleFormat::g:
+    return ".g";
+  case PuzzleFormat::mk:
+    return ".mk";
+  case PuzzleFormat::nin:
+    return ".nin";
+  case PuzzleFormat::nbn:
+    return ".nbn";
+  case PuzzleFormat::png:
+    return ".png";
+  }
+}
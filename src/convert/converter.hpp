@@ -0,0 +1,101 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_CONVERTER_HPP
+#define NONNY_CONVERTER_HPP
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <experimental/filesystem>
+#include "puzzle/puzzle_io.hpp"
+#include "puzzle/puzzle_pack.hpp"
+
+class Puzzle;
+
+/*
+ * Converts puzzle files between formats. A source directory is
+ * converted recursively, and its structure is mirrored under the
+ * destination directory. Files are converted in parallel, and failures
+ * are collected instead of stopping the run.
+ *
+ * A puzzle pack given as the source is extracted into the destination
+ * directory. In pack mode, every puzzle is instead added to the
+ * destination pack, which is written with a single commit.
+ */
+class Converter {
+public:
+  struct Options {
+    PuzzleFormat format = PuzzleFormat::non;
+    int jobs = 0; //0 means one per hardware thread
+    bool verify = false; //re-read each output and compare clues
+    bool pack = false; //write all puzzles into the pack file dest
+  };
+
+  struct Failure {
+    std::string path;
+    std::string message;
+  };
+
+  explicit Converter(const Options& options) : m_options(options) { }
+
+  // Convert a puzzle file or directory tree into dest
+  void run(const std::string& source, const std::string& dest);
+
+  int num_converted() const { return m_num_converted; }
+  int num_skipped() const { return m_num_skipped; }
+  const std::vector<Failure>& failures() const { return m_failures; }
+
+private:
+  typedef std::experimental::filesystem::path Path;
+
+  struct Job {
+    Path source;
+    Path dest; //relative to the source directory in pack mode
+    PuzzleFormat source_format;
+    const PuzzlePack::Entry* entry = nullptr; //if extracting a pack
+  };
+
+  void collect_jobs(const Path& source, const Path& dest);
+  void collect_pack_jobs(const Path& source, const Path& dest);
+  void add_job(const Path& source, const Path& dest_dir);
+  void convert(const Job& job);
+  void read_source(const Job& job, Puzzle& puzzle) const;
+  void report_failure(const Path& path, const std::string& message);
+
+  Options m_options;
+  std::vector<Job> m_jobs;
+  PuzzlePack m_source_pack;
+  PuzzlePack m_dest_pack;
+  std::mutex m_pack_mutex;
+  int m_num_converted = 0;
+  int m_num_skipped = 0;
+  std::vector<Failure> m_failures;
+  std::mutex m_failure_mutex;
+};
+
+// Look up a puzzle format by name or file extension (with or without
+// the leading dot), returns false if it is not a convertible format
+bool parse_puzzle_format(std::string name, PuzzleFormat& format);
+
+// Return the file extension, including the dot, used for a format
+std::string puzzle_format_extension(PuzzleFormat format);
+
+#endif
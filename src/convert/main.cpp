@@ -0,0 +1,125 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "convert/converter.hpp"
+#include "puzzle/puzzle_pack.hpp"
+#include "utility/utility.hpp"
+
+void print_usage(const char* program)
+{
+  std::cout << "Usage: " << program << " [OPTION]... SOURCE DEST\n"
+            << "  or:  " << program << " --compact PACK\n"
+            << "Convert the puzzle file or directory tree SOURCE into DEST,\n"
+            << "keeping the directory structure. If SOURCE is a puzzle\n"
+            << "pack (.npk), its puzzles are extracted into DEST.\n\n"
+            << "  -f, --format FMT  output format: non, g, mk, nin, or nbn\n"
+            << "                    (default non, or nbn with --pack)\n"
+            << "  -p, --pack        add every puzzle to the pack file DEST\n"
+            << "  -c, --compact     rewrite PACK without superseded data\n"
+            << "  -j, --jobs N      number of worker threads\n"
+            << "                    (default one per processor)\n"
+            << "  -v, --verify      re-read converted puzzles and compare "
+            << "clues\n"
+            << "  -h, --help        display this help and exit\n";
+}
+
+int main(int argc, char* argv[])
+{
+  Converter::Options options;
+  std::string source, dest;
+  bool format_given = false;
+  bool compact = false;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg == "-h" || arg == "--help") {
+        print_usage(argv[0]);
+        return 0;
+      } else if (arg == "-v" || arg == "--verify") {
+        options.verify = true;
+      } else if (arg == "-p" || arg == "--pack") {
+        options.pack = true;
+      } else if (arg == "-c" || arg == "--compact") {
+        compact = true;
+      } else if ((arg == "-f" || arg == "--format") && i + 1 < argc) {
+        if (!parse_puzzle_format(argv[++i], options.format))
+          throw std::invalid_argument(std::string("unknown format ")
+                                      + argv[i]);
+        format_given = true;
+      } else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+        options.jobs = str_to_uint(argv[++i]);
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unrecognized option " + arg);
+      } else if (source.empty()) {
+        source = arg;
+      } else if (dest.empty()) {
+        dest = arg;
+      } else {
+        throw std::invalid_argument("too many arguments");
+      }
+    }
+
+    if (compact && (source.empty() || !dest.empty()))
+      throw std::invalid_argument("--compact takes a single pack file");
+    else if (!compact && dest.empty())
+      throw std::invalid_argument("missing source or destination");
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    print_usage(argv[0]);
+    return 2;
+  }
+
+  if (options.pack && !format_given)
+    options.format = PuzzleFormat::nbn;
+
+  try {
+    if (compact) {
+      PuzzlePack pack(source);
+      auto wasted = pack.wasted_space();
+      pack.compact();
+      std::cout << "Removed " << wasted << " unused bytes" << std::endl;
+      return 0;
+    }
+
+    Converter converter(options);
+    converter.run(source, dest);
+
+    for (const auto& f : converter.failures())
+      std::cerr << f.path << ": " << f.message << "\n";
+
+    std::cout << "Converted " << converter.num_converted() << " puzzle"
+              << (converter.num_converted() == 1 ? "" : "s");
+    if (!converter.failures().empty())
+      std::cout << ", " << converter.failures().size() << " failed";
+    if (converter.num_skipped())
+      std::cout << ", skipped " << converter.num_skipped()
+                << " other file" << (converter.num_skipped() == 1 ? "" : "s");
+    std::cout << std::endl;
+
+    return converter.failures().empty() ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+}
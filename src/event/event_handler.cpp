@@ -22,6 +22,10 @@
 
 #include <stdexcept>
 #include "config.h"
+#include "event/input_event.hpp"
+#include "event/input_recorder.hpp"
+#include "input/input_handler.hpp"
+#include "view/view_manager.hpp"
 
 #ifdef NONNY_INPUT_SDL
 #include "event/sdl/sdl_event_handler.hpp"
@@ -36,3 +40,42 @@ std::unique_ptr<EventHandler> EventHandler::create()
                              "event handler not implemented");
   #endif
 }
+
+void EventHandler::dispatch(const InputEvent& event, InputHandler& input,
+                            ViewManager& view_mgr)
+{
+  if (m_quit_only) {
+    if (event.type == InputEvent::Type::quit)
+      view_mgr.schedule_action(ViewManager::Action::force_quit);
+    return;
+  }
+
+  if (m_recorder)
+    m_recorder->record(event);
+
+  switch (event.type) {
+  case InputEvent::Type::key:
+    input.process_key_event(static_cast<Keyboard::Key>(event.code),
+                            event.down);
+    break;
+  case InputEvent::Type::text:
+    input.process_text_input_event(event.text);
+    break;
+  case InputEvent::Type::mouse_button:
+    input.process_mouse_button_event(static_cast<Mouse::Button>(event.code),
+                                     event.down, event.clicks);
+    break;
+  case InputEvent::Type::mouse_wheel:
+    input.process_mouse_wheel_event(event.y, event.x);
+    break;
+  case InputEvent::Type::mouse_move:
+    input.process_mouse_move_event(event.x, event.y);
+    break;
+  case InputEvent::Type::resize:
+    view_mgr.resize(event.x, event.y);
+    break;
+  case InputEvent::Type::quit:
+    view_mgr.schedule_action(ViewManager::Action::quit_game);
+    break;
+  }
+}
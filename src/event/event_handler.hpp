@@ -25,7 +25,9 @@
 #include <memory>
 
 class InputHandler;
+class InputRecorder;
 class ViewManager;
+struct InputEvent;
 
 /*
  * Processes window events and passes input to input handler
@@ -41,6 +43,30 @@ public:
   virtual std::size_t get_ticks() const = 0;
 
   virtual void process(InputHandler&, ViewManager&) = 0;
+
+  //sleep until an event arrives, or until timeout milliseconds pass
+  virtual void wait_for_event() = 0;
+  virtual void wait_for_event(unsigned timeout) = 0;
+
+  //sleep for the given number of milliseconds, ignoring events
+  virtual void delay(unsigned time) = 0;
+
+  //copy every event passed on from now on to the recorder, or stop
+  //recording if it is null
+  void set_recorder(InputRecorder* recorder) { m_recorder = recorder; }
+
+  //drop every event except a request to quit, which then closes the
+  //game without asking to save; for a window driven by another source
+  void set_quit_only(bool quit_only = true) { m_quit_only = quit_only; }
+
+protected:
+  //pass an event on to the input handler or view manager
+  void dispatch(const InputEvent& event, InputHandler& input,
+                ViewManager& view_mgr);
+
+private:
+  InputRecorder* m_recorder = nullptr;
+  bool m_quit_only = false;
 };
 
 #endif
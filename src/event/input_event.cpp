@@ -0,0 +1,99 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "event/input_event.hpp"
+
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include "input/key.hpp"
+#include "utility/utility.hpp"
+
+std::ostream& operator<<(std::ostream& os, const InputEvent& event)
+{
+  switch (event.type) {
+  case InputEvent::Type::key:
+    os << "key " << event.code << " " << event.down;
+    break;
+  case InputEvent::Type::text:
+    os << "text \"" << unescape(event.text) << "\"";
+    break;
+  case InputEvent::Type::mouse_button:
+    os << "button " << event.code << " " << event.down
+       << " " << event.clicks;
+    break;
+  case InputEvent::Type::mouse_wheel:
+    os << "wheel " << event.y << " " << event.x;
+    break;
+  case InputEvent::Type::mouse_move:
+    os << "move " << event.x << " " << event.y;
+    break;
+  case InputEvent::Type::resize:
+    os << "resize " << event.x << " " << event.y;
+    break;
+  case InputEvent::Type::quit:
+    os << "quit";
+    break;
+  }
+  return os;
+}
+
+InputEvent parse_event(const std::string& line)
+{
+  auto prop = parse_property(line);
+  std::istringstream ss(prop.second);
+
+  InputEvent event;
+  if (prop.first == "key") {
+    event.type = InputEvent::Type::key;
+    ss >> event.code >> event.down;
+  } else if (prop.first == "text") {
+    event.type = InputEvent::Type::text;
+    event.text = prop.second;
+  } else if (prop.first == "button") {
+    event.type = InputEvent::Type::mouse_button;
+    ss >> event.code >> event.down >> event.clicks;
+  } else if (prop.first == "wheel") {
+    event.type = InputEvent::Type::mouse_wheel;
+    ss >> event.y >> event.x;
+  } else if (prop.first == "move") {
+    event.type = InputEvent::Type::mouse_move;
+    ss >> event.x >> event.y;
+  } else if (prop.first == "resize") {
+    event.type = InputEvent::Type::resize;
+    ss >> event.x >> event.y;
+  } else if (prop.first == "quit") {
+    event.type = InputEvent::Type::quit;
+  } else {
+    throw std::invalid_argument("::parse_event: unknown event "
+                                + prop.first);
+  }
+
+  int num_codes = 1;
+  if (event.type == InputEvent::Type::key)
+    num_codes = Keyboard::num_keys;
+  else if (event.type == InputEvent::Type::mouse_button)
+    num_codes = Mouse::num_buttons;
+
+  if (ss.fail() || event.code < 0 || event.code >= num_codes)
+    throw std::invalid_argument("::parse_event: invalid arguments for "
+                                + prop.first);
+  return event;
+}
@@ -0,0 +1,49 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_INPUT_EVENT_HPP
+#define NONNY_INPUT_EVENT_HPP
+
+#include <iosfwd>
+#include <string>
+
+/*
+ * A single input or window event, independent of where it came
+ * from. Events can be written one per line and parsed back, which is
+ * how input recordings are stored.
+ */
+struct InputEvent {
+  enum class Type { key, text, mouse_button, mouse_wheel, mouse_move,
+      resize, quit } type = Type::quit;
+
+  int code = 0;      //key or mouse button
+  bool down = false; //whether the key or button was pressed
+  int clicks = 1;    //number of clicks for mouse buttons
+  int x = 0;         //mouse position, wheel motion, or window size
+  int y = 0;
+  std::string text;  //text input
+};
+
+std::ostream& operator<<(std::ostream& os, const InputEvent& event);
+
+// Parse a line written by operator<<
+InputEvent parse_event(const std::string& line);
+
+#endif
@@ -0,0 +1,54 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "event/input_recorder.hpp"
+
+#include <stdexcept>
+#include "event/input_event.hpp"
+
+InputRecorder::InputRecorder(const std::string& filename,
+                             int width, int height)
+  : m_file(filename), m_filename(filename)
+{
+  if (!m_file.is_open())
+    throw std::runtime_error("InputRecorder::InputRecorder: "
+                             "could not open file " + filename);
+
+  m_file << input_recording_magic << " " << input_recording_version << "\n"
+         << "window " << width << " " << height << "\n";
+}
+
+void InputRecorder::begin_frame(std::size_t ticks)
+{
+  if (!m_started) {
+    m_started = true;
+    m_start_ticks = ticks;
+  }
+
+  m_file << "frame " << ticks - m_start_ticks << "\n";
+}
+
+void InputRecorder::record(const InputEvent& event)
+{
+  m_file << event << "\n";
+  if (!m_file)
+    throw std::runtime_error("InputRecorder::record: "
+                             "error writing to file " + m_filename);
+}
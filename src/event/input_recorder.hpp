@@ -0,0 +1,59 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_INPUT_RECORDER_HPP
+#define NONNY_INPUT_RECORDER_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+struct InputEvent;
+
+/*
+ * Writes input events to a file as they are processed, grouped by the
+ * frame they arrived in, so that the session can be played back by
+ * ReplayEventHandler. Frame times are stored relative to the first
+ * frame.
+ */
+class InputRecorder {
+public:
+  // The window size is stored so that playback can match it
+  InputRecorder(const std::string& filename, int width, int height);
+
+  InputRecorder(const InputRecorder&) = delete;
+  InputRecorder& operator=(const InputRecorder&) = delete;
+
+  // Must be called before each frame's events are recorded
+  void begin_frame(std::size_t ticks);
+  void record(const InputEvent& event);
+
+private:
+  std::ofstream m_file;
+  std::string m_filename;
+  bool m_started = false;
+  std::size_t m_start_ticks = 0;
+};
+
+// First line of a recording, followed by the format version
+constexpr const char* input_recording_magic = "nonny-input";
+constexpr int input_recording_version = 1;
+
+#endif
@@ -0,0 +1,167 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "event/replay/replay_event_handler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "event/input_recorder.hpp"
+#include "utility/utility.hpp"
+#include "view/view_manager.hpp"
+
+ReplayEventHandler::ReplayEventHandler(const std::string& filename,
+                                       bool real_time,
+                                       std::unique_ptr<EventHandler> live)
+  : m_live(std::move(live)), m_real_time(real_time)
+{
+  if (m_live)
+    m_live->set_quit_only();
+
+  std::ifstream file(filename);
+  if (!file.is_open())
+    throw std::runtime_error("ReplayEventHandler::ReplayEventHandler: "
+                             "could not open file " + filename);
+
+  try {
+    read(file);
+  } catch (const std::exception& e) {
+    throw std::runtime_error("ReplayEventHandler::ReplayEventHandler: "
+                             + filename + ": " + e.what());
+  }
+}
+
+std::size_t ReplayEventHandler::get_ticks() const
+{
+  if (m_real_time) {
+    //the clock starts when it is first read, not while loading
+    if (!m_started) {
+      m_start = Clock::now();
+      m_started = true;
+    }
+    auto elapsed = Clock::now() - m_start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+      .count();
+  }
+
+  if (m_frames.empty())
+    return 0;
+  return m_frames[std::min(m_next, m_frames.size() - 1)].ticks;
+}
+
+void ReplayEventHandler::process(InputHandler& input, ViewManager& view_mgr)
+{
+  if (m_live)
+    m_live->process(input, view_mgr);
+
+  if (finished()) {
+    //close without asking to save, nobody is there to answer
+    if (!m_quit_sent)
+      view_mgr.schedule_action(ViewManager::Action::force_quit);
+    m_quit_sent = true;
+    return;
+  }
+
+  //at full speed each call plays one recorded frame; in real time,
+  //play everything that is due, as a slow frame would have received
+  if (m_real_time) {
+    std::size_t now = get_ticks();
+    while (!finished() && m_frames[m_next].ticks <= now)
+      play_frame(input, view_mgr);
+  } else {
+    play_frame(input, view_mgr);
+  }
+}
+
+void ReplayEventHandler::wait_for_event()
+{
+  if (m_real_time && !finished())
+    sleep_until(m_frames[m_next].ticks);
+}
+
+void ReplayEventHandler::wait_for_event(unsigned timeout)
+{
+  if (m_real_time) {
+    std::size_t until = get_ticks() + timeout;
+    if (!finished())
+      until = std::min(until, m_frames[m_next].ticks);
+    sleep_until(until);
+  }
+}
+
+void ReplayEventHandler::delay(unsigned time)
+{
+  if (m_real_time)
+    std::this_thread::sleep_for(std::chrono::milliseconds(time));
+}
+
+void ReplayEventHandler::play_frame(InputHandler& input,
+                                    ViewManager& view_mgr)
+{
+  for (const auto& event : m_frames[m_next].events)
+    dispatch(event, input, view_mgr);
+  ++m_next;
+}
+
+void ReplayEventHandler::read(std::istream& is)
+{
+  std::string line;
+  std::getline(is, line);
+  std::istringstream ss(line);
+  std::string magic;
+  int version = 0;
+  ss >> magic >> version;
+  if (magic != input_recording_magic)
+    throw std::invalid_argument("not an input recording");
+  if (version != input_recording_version)
+    throw std::invalid_argument("unsupported version "
+                                + std::to_string(version));
+
+  while (std::getline(is, line)) {
+    auto prop = parse_property(line);
+    if (prop.first.empty())
+      continue;
+
+    if (prop.first == "window") {
+      std::istringstream args(prop.second);
+      args >> m_width >> m_height;
+      if (!args || m_width <= 0 || m_height <= 0)
+        throw std::invalid_argument("invalid window size");
+    } else if (prop.first == "frame") {
+      Frame frame;
+      frame.ticks = str_to_uint(prop.second);
+      if (!m_frames.empty() && frame.ticks < m_frames.back().ticks)
+        throw std::invalid_argument("frame times out of order");
+      m_frames.push_back(std::move(frame));
+    } else {
+      if (m_frames.empty())
+        throw std::invalid_argument("event before first frame");
+      m_frames.back().events.push_back(parse_event(line));
+    }
+  }
+}
+
+void ReplayEventHandler::sleep_until(std::size_t ticks) const
+{
+  get_ticks(); //make sure the clock has started
+  std::this_thread::sleep_until(m_start + std::chrono::milliseconds(ticks));
+}
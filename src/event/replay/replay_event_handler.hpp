@@ -0,0 +1,92 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_REPLAY_EVENT_HANDLER_HPP
+#define NONNY_REPLAY_EVENT_HANDLER_HPP
+
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "event/event_handler.hpp"
+#include "event/input_event.hpp"
+
+/*
+ * Plays back a file written by InputRecorder instead of reading live
+ * events. At full speed the clock follows the recorded frame times,
+ * so every frame sees the same input and elapsed time as when it was
+ * recorded and nothing ever waits. In real time, events are passed on
+ * once their recorded time has come. The game is closed when the
+ * recording runs out.
+ *
+ * If a live handler is given, its events are still processed every
+ * frame so the window stays responsive, but only a request to quit is
+ * acted on.
+ */
+class ReplayEventHandler : public EventHandler {
+public:
+  explicit ReplayEventHandler(const std::string& filename,
+                              bool real_time = false,
+                              std::unique_ptr<EventHandler> live = nullptr);
+
+  ReplayEventHandler(const ReplayEventHandler&) = delete;
+  ReplayEventHandler& operator=(const ReplayEventHandler&) = delete;
+
+  std::size_t get_ticks() const override;
+
+  void process(InputHandler& input, ViewManager& view_mgr) override;
+
+  void wait_for_event() override;
+  void wait_for_event(unsigned timeout) override;
+
+  void delay(unsigned time) override;
+
+  //window size at the time of recording
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+
+  std::size_t num_frames() const { return m_frames.size(); }
+  bool finished() const { return m_next == m_frames.size(); }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Frame {
+    std::size_t ticks = 0;
+    std::vector<InputEvent> events;
+  };
+
+  void play_frame(InputHandler& input, ViewManager& view_mgr);
+  void read(std::istream& is);
+  void sleep_until(std::size_t ticks) const;
+
+  std::unique_ptr<EventHandler> m_live;
+  std::vector<Frame> m_frames;
+  std::size_t m_next = 0; //next frame to play
+  int m_width = 800;
+  int m_height = 600;
+  bool m_real_time;
+  mutable Clock::time_point m_start;
+  mutable bool m_started = false;
+  bool m_quit_sent = false;
+};
+
+#endif
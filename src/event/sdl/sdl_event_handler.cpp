@@ -20,59 +20,67 @@
 
 #include "event/sdl/sdl_event_handler.hpp"
 
-#include "input/input_handler.hpp"
+#include "event/input_event.hpp"
+#include "video/renderer.hpp"
 #include "view/view_manager.hpp"
 
 void SDLEventHandler::process(InputHandler& input, ViewManager& view_mgr)
 {
   SDL_Event event;
   while (SDL_PollEvent(&event)) {
+    InputEvent ev;
     switch (event.type) {
     case SDL_QUIT:
-      view_mgr.schedule_action(ViewManager::Action::quit_game);
+      ev.type = InputEvent::Type::quit;
       break;
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+      //not input, so it is neither recorded nor replayed
+      view_mgr.renderer().targets_reset();
+      continue;
     case SDL_WINDOWEVENT:
-      switch (event.window.event) {
-      case SDL_WINDOWEVENT_RESIZED:
-        view_mgr.resize(event.window.data1, event.window.data2);
-        break;
-      }
+      if (event.window.event != SDL_WINDOWEVENT_RESIZED)
+        continue;
+      ev.type = InputEvent::Type::resize;
+      ev.x = event.window.data1;
+      ev.y = event.window.data2;
       break;
     case SDL_KEYDOWN:
     case SDL_KEYUP:
-      {
-        Keyboard::Key key = convert_keycode(event.key.keysym.scancode);
-        bool down = (event.type == SDL_KEYDOWN);
-        input.process_key_event(key, down);
-      }
+      ev.type = InputEvent::Type::key;
+      ev.code = convert_keycode(event.key.keysym.scancode);
+      ev.down = (event.type == SDL_KEYDOWN);
       break;
     case SDL_TEXTINPUT:
-      input.process_text_input_event(event.text.text);
+      ev.type = InputEvent::Type::text;
+      ev.text = event.text.text;
       break;
     case SDL_MOUSEBUTTONDOWN:
     case SDL_MOUSEBUTTONUP:
-      {
-        Mouse::Button button = convert_mouse_button(event.button.button);
-        bool down = (event.type == SDL_MOUSEBUTTONDOWN);
-        unsigned num_clicks = event.button.clicks;
-        input.process_mouse_button_event(button, down, num_clicks);
-      }
+      ev.type = InputEvent::Type::mouse_button;
+      ev.code = convert_mouse_button(event.button.button);
+      ev.down = (event.type == SDL_MOUSEBUTTONDOWN);
+      ev.clicks = event.button.clicks;
       break;
     case SDL_MOUSEMOTION:
-      input.process_mouse_move_event(event.motion.x, event.motion.y);
+      ev.type = InputEvent::Type::mouse_move;
+      ev.x = event.motion.x;
+      ev.y = event.motion.y;
       break;
     case SDL_MOUSEWHEEL:
-      {
-        int vert = event.wheel.y;
-        int horiz = event.wheel.x;
-        if (event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED) {
-          vert = -vert;
-          horiz = -horiz;
-        }
-        input.process_mouse_wheel_event(vert, horiz);
+      ev.type = InputEvent::Type::mouse_wheel;
+      ev.y = event.wheel.y;
+      ev.x = event.wheel.x;
+      if (event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED) {
+        ev.y = -ev.y;
+        ev.x = -ev.x;
       }
       break;
+    default:
+      continue;
     }
+
+    dispatch(ev, input, view_mgr);
   }
 }
 
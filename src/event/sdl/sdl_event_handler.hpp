@@ -39,6 +39,13 @@ public:
 
   void process(InputHandler& input, ViewManager& view_mgr) override;
 
+  void wait_for_event() override { SDL_WaitEvent(NULL); }
+  void wait_for_event(unsigned timeout) override {
+    SDL_WaitEventTimeout(NULL, timeout);
+  }
+
+  void delay(unsigned time) override { SDL_Delay(time); }
+
 private:
   static Keyboard::Key convert_keycode(SDL_Scancode key);
   static Mouse::Button convert_mouse_button(Uint8 button);
@@ -20,6 +20,7 @@
 
 #include "input/input_handler.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include "config.h"
 
@@ -119,6 +120,12 @@ int InputHandler::num_key_presses(Keyboard::Key key) const
   return m_num_presses[key];
 }
 
+bool InputHandler::is_input_held() const
+{
+  return std::find(m_keys.begin(), m_keys.end(), true) != m_keys.end()
+    || std::find(m_buttons.begin(), m_buttons.end(), true) != m_buttons.end();
+}
+
 bool InputHandler::is_ctrl_down() const
 {
   return is_key_down(Keyboard::Key::lctrl)
@@ -62,6 +62,9 @@ public:
   virtual bool is_key_down(Keyboard::Key key) const;
   virtual int num_key_presses(Keyboard::Key key) const;
 
+  // Determine whether any key or mouse button is being held down
+  virtual bool is_input_held() const;
+
   virtual bool is_ctrl_down() const;
   virtual bool is_shift_down() const;
   virtual bool is_alt_down() const;
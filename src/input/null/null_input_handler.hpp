@@ -0,0 +1,49 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_NULL_INPUT_HANDLER_HPP
+#define NONNY_NULL_INPUT_HANDLER_HPP
+
+#include "input/input_handler.hpp"
+
+/*
+ * Input handler with no device behind it. Input is supplied by
+ * calling the process_*_event functions directly, and the cursor is
+ * only remembered.
+ */
+class NullInputHandler : public InputHandler {
+public:
+  NullInputHandler() { }
+
+  NullInputHandler(const NullInputHandler&) = delete;
+  NullInputHandler& operator=(const NullInputHandler&) = delete;
+
+  void capture_mouse() override { }
+  void release_mouse() override { }
+
+  void set_cursor(Mouse::Cursor cursor) override { m_cursor = cursor; }
+  void reset_cursor() override { m_cursor = Mouse::Cursor::arrow; }
+  Mouse::Cursor cursor() const override { return m_cursor; }
+
+private:
+  Mouse::Cursor m_cursor = Mouse::Cursor::arrow;
+};
+
+#endif
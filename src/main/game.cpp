@@ -21,23 +21,46 @@
 #include "main/game.hpp"
 
 #include <cstddef>
+#include <iostream>
 #include "config.h"
 #include "color/color.hpp"
 #include "event/event_handler.hpp"
+#include "event/replay/replay_event_handler.hpp"
 #include "input/input_handler.hpp"
 #include "settings/game_settings.hpp"
+#include "ui/profiler_overlay.hpp"
+#include "utility/profiler.hpp"
+#include "utility/utility.hpp"
 #include "video/font.hpp"
 #include "view/menu_view.hpp"
 #include "view/puzzle_view.hpp"
 
+constexpr unsigned min_frame_time = 1000 / 60;
+
 Game::Game(int argc, char* argv[])
 {
-  m_video = VideoSystem::create();
+  Options options = parse_options(argc, argv);
+  if (options.import_colors > 0)
+    m_settings.set_import_colors(options.import_colors);
 
   WindowSettings ws;
   ws.title = NONNY_TITLE;
   ws.icon = m_settings.image_dir()
     + m_settings.filesystem_separator() + "nonny.png";
+
+  //a replay must start from the window size it was recorded at
+  if (!options.replay_file.empty()) {
+    auto replay = std::make_unique<ReplayEventHandler>(options.replay_file,
+                                                       options.real_time,
+                                                       EventHandler::create());
+    ws.width = replay->width();
+    ws.height = replay->height();
+    m_event = std::move(replay);
+  } else {
+    m_event = EventHandler::create();
+  }
+
+  m_video = VideoSystem::create();
   m_window = m_video->new_window(ws);
   m_renderer = m_video->new_renderer(*m_window);
 
@@ -47,25 +70,39 @@ Game::Game(int argc, char* argv[])
                                              m_window->width(),
                                              m_window->height());
   m_view_mgr->schedule_action(ViewManager::Action::open_menu);
+
+  if (!options.record_file.empty()) {
+    m_recorder = std::make_unique<InputRecorder>(options.record_file,
+                                                 m_window->width(),
+                                                 m_window->height());
+    m_event->set_recorder(m_recorder.get());
+  }
 }
 
 void Game::run()
 {
   std::unique_ptr<InputHandler> input = InputHandler::create();
-  std::unique_ptr<EventHandler> event = EventHandler::create();
+  EventHandler* event = m_event.get();
 
   bool exit = false;
   std::size_t prev_ticks = event->get_ticks();
   std::size_t ticks = prev_ticks;
   unsigned elapsed = 0;
+  bool was_idle = false;
+  Profiler& profiler = Profiler::instance();
   while (!exit) {
     ticks = event->get_ticks();
     elapsed = ticks - prev_ticks;
     prev_ticks = ticks;
 
+    profiler.begin_frame();
+    if (m_recorder)
+      m_recorder->begin_frame(ticks);
+
     input->update(elapsed);
 
     event->process(*input, *m_view_mgr);
+    handle_profiler_keys(*input);
 
     m_renderer->set_draw_color(default_colors::white);
     m_renderer->clear();
@@ -73,8 +110,83 @@ void Game::run()
     m_view_mgr->update(elapsed, *input);
     m_view_mgr->draw(*m_renderer);
 
+    if (profiler.is_enabled())
+      draw_profiler_overlay(*m_renderer, Point(0, 0), *m_overlay_font);
+
     m_renderer->present();
+    profiler.end_frame();
 
     exit = m_view_mgr->empty();
+
+    //cap the frame rate in case vsync is unavailable
+    unsigned frame_time = event->get_ticks() - ticks;
+    if (!exit && frame_time < min_frame_time)
+      event->delay(min_frame_time - frame_time);
+
+    //if nothing is going on, sleep until there is input or the view
+    //next needs updating; wait for two quiet frames in a row so that
+    //anything scheduled in response to the last input gets handled
+    unsigned timeout = m_view_mgr->update_timeout();
+    if (input->is_input_held())
+      timeout = 0;
+    if (!exit && timeout > min_frame_time && was_idle) {
+      if (timeout == no_update_timeout)
+        event->wait_for_event();
+      else
+        event->wait_for_event(timeout - min_frame_time);
+    }
+    was_idle = timeout > min_frame_time;
+  }
+}
+
+Game::Options Game::parse_options(int argc, char* argv[])
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--record" && i + 1 < argc)
+      options.record_file = argv[++i];
+    else if (arg == "--replay" && i + 1 < argc)
+      options.replay_file = argv[++i];
+    else if (arg == "--real-time")
+      options.real_time = true;
+    else if (arg == "--import-colors" && i + 1 < argc) {
+      try {
+        options.import_colors = static_cast<int>(str_to_uint(argv[++i]));
+      } catch (const std::exception&) {
+        std::cerr << "Game::parse_options: invalid color count "
+                  << argv[i] << std::endl;
+      }
+    }
+    else //the platform may pass its own arguments, so just warn
+      std::cerr << "Game::parse_options: ignoring unrecognized option "
+                << arg << std::endl;
+  }
+  return options;
+}
+
+void Game::handle_profiler_keys(InputHandler& input)
+{
+  Profiler& profiler = Profiler::instance();
+
+  //F3 toggles frame profiling and its overlay
+  if (input.was_key_pressed(Keyboard::Key::f3)) {
+    if (!m_overlay_font) {
+      std::string font_file = m_settings.font_dir()
+        + m_settings.filesystem_separator() + "FreeSans.ttf";
+      m_overlay_font = m_video->new_font(font_file, 12);
+    }
+    profiler.set_enabled(!profiler.is_enabled());
+  }
+
+  //F4 writes the recorded frames to the save directory
+  if (input.was_key_pressed(Keyboard::Key::f4) && profiler.num_frames()) {
+    std::string filename = m_settings.save_dir()
+      + m_settings.filesystem_separator() + "profile.csv";
+    try {
+      profiler.write_file(filename);
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
   }
 }
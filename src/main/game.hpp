@@ -22,12 +22,17 @@
 #define NONNY_GAME_HPP
 
 #include <memory>
+#include "event/event_handler.hpp"
+#include "event/input_recorder.hpp"
 #include "settings/game_settings.hpp"
+#include "video/font.hpp"
 #include "video/renderer.hpp"
 #include "video/video_system.hpp"
 #include "video/window.hpp"
 #include "view/view_manager.hpp"
 
+class InputHandler;
+
 /*
  * Manages game resources at a high level
  */
@@ -37,11 +42,24 @@ public:
 
   void run();
 private:
+  struct Options {
+    std::string record_file; //write all input to this file
+    std::string replay_file; //read input from this file instead
+    bool real_time = false;  //replay at the recorded speed
+    int import_colors = 0;   //color limit for imported images, if set
+  };
+
+  static Options parse_options(int argc, char* argv[]);
+  void handle_profiler_keys(InputHandler& input);
+
   bool m_exit;
   std::unique_ptr<VideoSystem> m_video;
   std::unique_ptr<Window> m_window;
   std::unique_ptr<Renderer> m_renderer;
   std::unique_ptr<ViewManager> m_view_mgr;
+  std::unique_ptr<EventHandler> m_event;
+  std::unique_ptr<InputRecorder> m_recorder;
+  std::unique_ptr<Font> m_overlay_font;
   GameSettings m_settings;
 };
 
@@ -21,8 +21,10 @@
 #include "puzzle/puzzle.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <set>
 #include "solver/line_solver.hpp"
+#include "utility/profiler.hpp"
 
 Puzzle::Puzzle(int width, int height)
   : m_grid(width, height)
@@ -38,6 +40,12 @@ Puzzle::Puzzle(int width, int height, ColorPalette palette)
   update(true);
 }
 
+unsigned long Puzzle::new_revision()
+{
+  static std::atomic<unsigned long> last_revision(0);
+  return ++last_revision;
+}
+
 PuzzleLine Puzzle::get_row(int index)
 {
   return PuzzleLine(*this, index, LineType::row);
@@ -64,6 +72,7 @@ void Puzzle::mark_cell(int col, int row, const Color& color)
   cell.state = PuzzleCell::State::filled;
   cell.color = color;
 
+  touch();
   m_rows_changed.insert(row);
   m_cols_changed.insert(col);
 }
@@ -72,6 +81,7 @@ void Puzzle::clear_cell(int col, int row)
 {
   m_grid.at(col, row).state = PuzzleCell::State::blank;
 
+  touch();
   m_rows_changed.insert(row);
   m_cols_changed.insert(col);
 }
@@ -80,14 +90,43 @@ void Puzzle::cross_out_cell(int col, int row)
 {
   m_grid.at(col, row).state = PuzzleCell::State::crossed_out;
 
+  touch();
   m_rows_changed.insert(row);
   m_cols_changed.insert(col);
 }
 
+void Puzzle::set_spans(const std::vector<Span>& spans,
+                       PuzzleCell::State state, const Color& color)
+{
+  std::vector<bool> cols_changed(width(), false);
+  for (const auto& span : spans) {
+    int begin = std::max(span.begin, 0);
+    int end = std::min(span.end, width());
+    if (span.row < 0 || span.row >= height() || begin >= end)
+      continue;
+
+    PuzzleCell* cells = m_grid.row(span.row);
+    for (int col = begin; col < end; ++col) {
+      cells[col].state = state;
+      if (state == PuzzleCell::State::filled)
+        cells[col].color = color;
+      cols_changed[col] = true;
+    }
+    m_rows_changed.insert(span.row);
+  }
+
+  for (int col = 0; col < width(); ++col)
+    if (cols_changed[col])
+      m_cols_changed.insert(m_cols_changed.end(), col);
+
+  touch();
+}
+
 void Puzzle::clear_all_cells()
 {
   m_grid = PuzzleGrid(width(), height());
 
+  touch();
   refresh_all_cells();
 }
 
@@ -102,20 +141,60 @@ void Puzzle::refresh_all_cells()
 void Puzzle::shift_cells(int x, int y)
 {
   int wd = width(), ht = height();
-  PuzzleGrid copy(m_grid);
-  m_grid = PuzzleGrid(wd, ht);
+  if (static_cast<int>(m_row_clues.size()) != ht
+      || static_cast<int>(m_col_clues.size()) != wd) {
+    m_grid.shift(x, y);
+    touch();
+    refresh_all_cells();
+    return;
+  }
 
+  //lines keep their clues unless filled cells are shifted off the grid
+  std::vector<bool> rows_lost(ht, false), cols_lost(wd, false);
+  int lost_col_begin = x > 0 ? std::max(wd - x, 0) : 0;
+  int lost_col_end = x > 0 ? wd : std::min(-x, wd);
+  int lost_row_begin = y > 0 ? std::max(ht - y, 0) : 0;
+  int lost_row_end = y > 0 ? ht : std::min(-y, ht);
   for (int row = 0; row < ht; ++row) {
-    for (int col = 0; col < wd; ++col) {
-      int new_row = row + y;
-      int new_col = col + x;
+    const PuzzleCell* cells = m_grid.row(row);
+    bool whole_row = row >= lost_row_begin && row < lost_row_end;
+    int begin = whole_row ? 0 : lost_col_begin;
+    int end = whole_row ? wd : lost_col_end;
+    for (int col = begin; col < end; ++col) {
+      if (cells[col].state == PuzzleCell::State::filled) {
+        if (col >= lost_col_begin && col < lost_col_end)
+          rows_lost[row] = true;
+        if (whole_row)
+          cols_lost[col] = true;
+      }
+    }
+  }
 
-      if (new_row >= 0 && new_row < ht
-          && new_col >= 0 && new_col < wd)
-        m_grid.at(new_col, new_row) = copy.at(col, row);
+  m_grid.shift(x, y);
+  touch();
+  shift_lines(m_row_clues, m_rows_changed, rows_lost, y);
+  shift_lines(m_col_clues, m_cols_changed, cols_lost, x);
+}
+
+void Puzzle::shift_lines(ClueContainer& clues, std::set<int>& changed,
+                         const std::vector<bool>& lost, int offset)
+{
+  int count = clues.size();
+  ClueContainer shifted(count);
+  std::set<int> shifted_changed;
+  for (int i = 0; i < count; ++i) {
+    int src = i - offset;
+    if (src < 0 || src >= count) {
+      shifted[i] = ClueSequence(1, PuzzleClue()); //line is now empty
+    } else {
+      shifted[i] = std::move(clues[src]);
+      if (lost[src] || changed.count(src))
+        shifted_changed.insert(shifted_changed.end(), i);
     }
   }
-  refresh_all_cells();
+
+  clues = std::move(shifted);
+  changed = std::move(shifted_changed);
 }
 
 void Puzzle::copy_state(CompressedState& state) const
@@ -153,6 +232,7 @@ void Puzzle::load_state(const CompressedState& state)
     }
   }
 
+  touch();
   if (old_size != m_grid.width() * m_grid.height())
     handle_size_change();
   refresh_all_cells();
@@ -191,6 +271,8 @@ bool Puzzle::is_clear() const
 
 void Puzzle::update(bool edit_mode)
 {
+  ScopedTimer timer(Profiler::Section::puzzle_update);
+
   //make sure clue entries exist
   if (m_row_clues.empty())
     m_row_clues = ClueContainer(height(), ClueSequence());
@@ -244,18 +326,44 @@ void Puzzle::set_property(const std::string& property,
 
 void Puzzle::resize(int width, int height)
 {
-  PuzzleGrid copy(m_grid);
-  m_grid = PuzzleGrid(width, height);
-
-  int common_width = std::min(width, copy.width());
-  int common_height = std::min(height, copy.height());
-  for (int row = 0; row < common_height; ++row) {
-    for (int col = 0; col < common_width; ++col) {
-      m_grid.at(col, row) = copy.at(col, row);
+  int old_width = this->width(), old_height = this->height();
+  if (static_cast<int>(m_row_clues.size()) != old_height
+      || static_cast<int>(m_col_clues.size()) != old_width
+      || width <= 0 || height <= 0) {
+    m_grid.resize(width, height);
+    touch();
+    handle_size_change();
+    return;
+  }
+
+  //only lines that lose filled cells need new clues
+  int common_width = std::min(width, old_width);
+  int common_height = std::min(height, old_height);
+  for (int row = 0; row < old_height; ++row) {
+    const PuzzleCell* cells = m_grid.row(row);
+    int begin = row < common_height ? common_width : 0;
+    for (int col = begin; col < old_width; ++col) {
+      if (cells[col].state == PuzzleCell::State::filled) {
+        if (row < common_height)
+          m_rows_changed.insert(row);
+        if (col < common_width)
+          m_cols_changed.insert(col);
+      }
     }
   }
 
-  handle_size_change();
+  m_grid.resize(width, height);
+  touch();
+
+  m_row_clues.resize(height, ClueSequence(1, PuzzleClue()));
+  m_col_clues.resize(width, ClueSequence(1, PuzzleClue()));
+  m_rows_changed.erase(m_rows_changed.lower_bound(height),
+                       m_rows_changed.end());
+  m_cols_changed.erase(m_cols_changed.lower_bound(width),
+                       m_cols_changed.end());
+  m_rows_solved.clear();
+  m_cols_solved.clear();
+  update(true);
 }
 
 void Puzzle::handle_size_change()
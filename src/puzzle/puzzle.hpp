@@ -66,6 +66,7 @@ public:
 
   ConstPuzzleLine operator[](int col) const;
   inline const PuzzleCell& at(int col, int row) const;
+  const PuzzleGrid& grid() const { return m_grid; }
 
   void mark_cell(int col, int row, const Color& color = Color());
   void clear_cell(int col, int row);
@@ -73,6 +74,28 @@ public:
 
   void clear_all_cells();
 
+  // Columns begin up to (not including) end of a row
+  struct Span {
+    int row;
+    int begin;
+    int end;
+  };
+
+  /*
+   * Set the state of every cell in the given spans, as if by calling
+   * mark_cell, clear_cell or cross_out_cell on each of them. Each
+   * affected line is flagged for update only once. Color is only
+   * used for filled cells.
+   */
+  void set_spans(const std::vector<Span>& spans, PuzzleCell::State state,
+                 const Color& color = Color());
+
+  /*
+   * Move the cells x columns right and y rows down. Clues move with
+   * their lines; only lines that lose filled cells off the edge are
+   * flagged for update. Like resize, this assumes clues are derived
+   * from the cells, as they are in edit mode.
+   */
   void shift_cells(int x, int y);
 
   void copy_state(CompressedState& state) const;
@@ -113,6 +136,15 @@ public:
   const std::string&
   property(const std::string& p) const { return m_properties.at(p); }
 
+  const Properties& properties() const { return m_properties; }
+
+  /*
+   * Returns a number that changes whenever the cells of the grid
+   * may have changed. Revisions are unique across all puzzles, so a
+   * puzzle that has been replaced by another compares as changed.
+   */
+  unsigned long revision() const { return m_revision; }
+
   const ClueContainer& row_clues() const { return m_row_clues; }
   const ClueContainer& col_clues() const { return m_col_clues; }
   inline const ClueSequence& row_clues(int row) const;
@@ -122,8 +154,13 @@ public:
   Puzzle& operator=(Puzzle&&) & = default;
 
 private:
+  static unsigned long new_revision();
+  void touch() { m_revision = new_revision(); }
+
   void refresh_all_cells();
   void handle_size_change();
+  static void shift_lines(ClueContainer& clues, std::set<int>& changed,
+                          const std::vector<bool>& lost, int offset);
   ClueSequence& line_clues(int index, LineType type);
   void update_line(int index, LineType type, bool edit_mode);
 
@@ -136,6 +173,7 @@ private:
   std::set<int> m_cols_changed;
   std::set<int> m_rows_solved;
   std::set<int> m_cols_solved;
+  unsigned long m_revision = new_revision();
 };
 
 // Reads and writes puzzles in the .non format
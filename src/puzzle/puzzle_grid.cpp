@@ -20,6 +20,7 @@
 
 #include "puzzle/puzzle_grid.hpp"
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <stdexcept>
@@ -45,6 +46,80 @@ const PuzzleCell& PuzzleGrid::at(int x, int y) const
   return m_grid[pos];
 }
 
+void PuzzleGrid::resize(int width, int height)
+{
+  int old_width = m_width, old_height = this->height();
+  if (old_width == 0 || width == 0) {
+    *this = PuzzleGrid(width, height);
+    return;
+  }
+
+  int common_height = std::min(height, old_height);
+  auto first = m_grid.begin();
+  if (width < old_width) {
+    //rows move toward the front, so go forward
+    for (int y = 1; y < common_height; ++y)
+      std::copy(first + y * old_width, first + y * old_width + width,
+                first + y * width);
+  } else if (width > old_width) {
+    //rows move toward the back, so go backward
+    std::size_t size = std::max(m_grid.size(),
+                                static_cast<std::size_t>(width * height));
+    m_grid.resize(size);
+    first = m_grid.begin();
+    for (int y = common_height - 1; y > 0; --y)
+      std::copy_backward(first + y * old_width,
+                         first + (y + 1) * old_width,
+                         first + y * width + old_width);
+    for (int y = 0; y < common_height; ++y)
+      std::fill(first + y * width + old_width, first + (y + 1) * width,
+                PuzzleCell());
+  }
+
+  m_grid.resize(width * height);
+  std::fill(m_grid.begin() + common_height * width, m_grid.end(),
+            PuzzleCell());
+  m_width = width;
+}
+
+void PuzzleGrid::shift(int x, int y)
+{
+  int wd = width(), ht = height();
+  if (x == 0 && y == 0)
+    return;
+  if (x <= -wd || x >= wd || y <= -ht || y >= ht) {
+    std::fill(m_grid.begin(), m_grid.end(), PuzzleCell());
+    return;
+  }
+
+  //the part of each source row that stays on the grid
+  int src_begin = std::max(-x, 0);
+  int src_end = wd - std::max(x, 0);
+
+  //visit rows so that no source row is overwritten before it is read
+  for (int i = 0; i < ht; ++i) {
+    int dest_row = y > 0 ? ht - 1 - i : i;
+    int src_row = dest_row - y;
+    PuzzleCell* dest = row(dest_row);
+
+    if (src_row < 0 || src_row >= ht) {
+      std::fill(dest, dest + wd, PuzzleCell());
+      continue;
+    }
+
+    PuzzleCell* src = row(src_row);
+    if (x > 0)
+      std::copy_backward(src + src_begin, src + src_end, dest + wd);
+    else
+      std::copy(src + src_begin, src + src_end, dest);
+
+    if (x > 0)
+      std::fill(dest, dest + x, PuzzleCell());
+    else
+      std::fill(dest + wd + x, dest + wd, PuzzleCell());
+  }
+}
+
 std::ostream& operator<<(std::ostream& os, const PuzzleGrid& grid)
 {
   ColorPalette palette;
@@ -48,6 +48,22 @@ public:
   PuzzleCell& at(int x, int y);
   const PuzzleCell& at(int x, int y) const;
 
+  // Cells of row y, without bounds checking, for bulk operations
+  PuzzleCell* row(int y) { return m_grid.data() + y * m_width; }
+  const PuzzleCell* row(int y) const { return m_grid.data() + y * m_width; }
+
+  /*
+   * Change the dimensions in place, keeping the cells in the top-left
+   * corner. New cells are blank.
+   */
+  void resize(int width, int height);
+
+  /*
+   * Move every cell x columns right and y rows down in place. Cells
+   * moved off the grid are lost, and vacated cells become blank.
+   */
+  void shift(int x, int y);
+
   PuzzleGrid& operator=(const PuzzleGrid&) & = default;
   PuzzleGrid& operator=(PuzzleGrid&&) & = default;
 private:
@@ -22,6 +22,8 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -32,6 +34,7 @@
 #include "color/color_palette.hpp"
 #include "puzzle/puzzle.hpp"
 #include "puzzle/puzzle_summary.hpp"
+#include "utility/binary_io.hpp"
 #include "utility/utility.hpp"
 
 enum class ClueType { row, col };
@@ -72,6 +75,12 @@ namespace nin_format {
   std::istream& skim(std::istream& is, PuzzleSummary& summary);
 }
 
+namespace nbn_format {
+  std::ostream& write(std::ostream& os, const Puzzle& puzzle);
+  std::istream& read(std::istream& is, PuzzleBlueprint& blueprint);
+  std::istream& skim(std::istream& is, PuzzleSummary& summary);
+}
+
 std::ostream& write_puzzle(std::ostream& os, Puzzle puzzle,
                            PuzzleFormat fmt)
 {
@@ -88,6 +97,8 @@ std::ostream& write_puzzle(std::ostream& os, Puzzle puzzle,
     return mk_format::write(os, puzzle);
   case PuzzleFormat::nin:
     return nin_format::write(os, puzzle);
+  case PuzzleFormat::nbn:
+    return nbn_format::write(os, puzzle);
   }
 }
 
@@ -109,6 +120,9 @@ std::istream& read_puzzle(std::istream& is, Puzzle& puzzle,
   case PuzzleFormat::nin:
     nin_format::read(is, blueprint);
     break;
+  case PuzzleFormat::nbn:
+    nbn_format::read(is, blueprint);
+    break;
   }
 
   puzzle = Puzzle();
@@ -135,6 +149,8 @@ std::istream& skim_puzzle(std::istream& is, PuzzleSummary& summary,
     return mk_format::skim(is, summary);
   case PuzzleFormat::nin:
     return nin_format::skim(is, summary);
+  case PuzzleFormat::nbn:
+    return nbn_format::skim(is, summary);
   }
 }
 
@@ -923,3 +939,407 @@ nin_format::skim(std::istream& is, PuzzleSummary& summary)
 
   return is;
 }
+
+
+/* .nbn format */
+
+/*
+ * The .nbn format is a compact binary encoding of a .non puzzle. All
+ * integers are stored as unsigned LEB128 varints and strings are
+ * stored as a varint length followed by the raw bytes. The layout is
+ *
+ *   magic        "NBN\x1a"
+ *   version      1 byte
+ *   flags        1 byte (see below)
+ *   header size  varint, number of bytes in the header that follows
+ *   header       width, height, title, author, collection, id
+ *   properties   count, then name/value string pairs
+ *   palette      count, then r, g, b, symbol bytes and a name string
+ *   clue color   varint palette index (only when colored_clues is unset)
+ *   row clues    for each row: clue count, then the clue values
+ *   col clues    for each column: clue count, then the clue values
+ *   solution     byte count, plane count, then for each plane a
+ *                palette index and width * height bits, row-major
+ *
+ * When colored_clues is set each clue value is followed by its palette
+ * index. Palette indices are 1-based, 0 stands for the default color.
+ * The solution section is only present if has_solution is set. Since
+ * the summary fields sit in the header, skimming a file never needs to
+ * read past it.
+ */
+namespace nbn_format {
+  const char magic[] = { 'N', 'B', 'N', '\x1a' };
+  const int version = 1;
+
+  enum Flags : unsigned {
+    multicolor = 1u << 0,
+    colored_clues = 1u << 1,
+    has_solution = 1u << 2
+  };
+
+  /* .nbn output */
+  std::string& put_clues(std::string& buf, const Puzzle::ClueContainer& clues,
+                         const ColorPalette& palette, bool colored);
+  std::string& put_solution(std::string& buf, const Puzzle& puzzle);
+
+  unsigned color_index(const ColorPalette& palette, const Color& color);
+  bool has_uniform_clue_color(const Puzzle& puzzle);
+  bool is_grid_solution(const Puzzle& puzzle);
+
+  /* .nbn input */
+  std::istream& read_prefix(std::istream& is, unsigned& flags,
+                            std::string& header);
+  int read_dimension(ByteReader& rd);
+  void read_header(ByteReader& rd, int& width, int& height,
+                   PuzzleSummary* summary);
+  void read_clues(ByteReader& rd, Puzzle::ClueContainer& clues, int count,
+                  const std::vector<Color>& colors, bool colored,
+                  const Color& clue_color);
+  const Color& lookup_color(const std::vector<Color>& colors,
+                            std::uint64_t index);
+}
+
+unsigned
+nbn_format::color_index(const ColorPalette& palette, const Color& color)
+{
+  auto it = palette.find(color);
+  if (it == palette.end())
+    return 0;
+  return static_cast<unsigned>(it - palette.begin()) + 1;
+}
+
+bool nbn_format::has_uniform_clue_color(const Puzzle& puzzle)
+{
+  const Color* first = nullptr;
+  for (const auto* clues : { &puzzle.row_clues(), &puzzle.col_clues() }) {
+    for (const auto& seq : *clues) {
+      for (const auto& clue : seq) {
+        if (!first)
+          first = &clue.color;
+        else if (clue.color != *first)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Determine whether the puzzle's current grid satisfies its clues, in
+ * which case it is worth storing as the solution.
+ */
+bool nbn_format::is_grid_solution(const Puzzle& puzzle)
+{
+  if (puzzle.width() == 0 || puzzle.height() == 0 || puzzle.is_clear())
+    return false;
+
+  //compare the runs of filled cells in a line against its clues
+  auto line_matches = [](const ConstPuzzleLine& line,
+                         const Puzzle::ClueSequence& clues) {
+    std::size_t clue = 0;
+    int pos = 0;
+    while (pos < line.size()) {
+      if (line[pos].state != PuzzleCell::State::filled) {
+        ++pos;
+        continue;
+      }
+
+      const Color& color = line[pos].color;
+      int count = 0;
+      while (pos < line.size()
+             && line[pos].state == PuzzleCell::State::filled
+             && line[pos].color == color) {
+        ++count;
+        ++pos;
+      }
+
+      if (clue == clues.size() || clues[clue].value != count
+          || clues[clue].color != color)
+        return false;
+      ++clue;
+    }
+
+    //an empty line is described by a single zero clue
+    while (clue < clues.size() && clues[clue].value == 0)
+      ++clue;
+    return clue == clues.size();
+  };
+
+  for (int row = 0; row < puzzle.height(); ++row)
+    if (!line_matches(puzzle.get_row(row), puzzle.row_clues(row)))
+      return false;
+  for (int col = 0; col < puzzle.width(); ++col)
+    if (!line_matches(puzzle.get_col(col), puzzle.col_clues(col)))
+      return false;
+  return true;
+}
+
+std::string&
+nbn_format::put_clues(std::string& buf, const Puzzle::ClueContainer& clues,
+                      const ColorPalette& palette, bool colored)
+{
+  for (const auto& seq : clues) {
+    put_varint(buf, seq.size());
+    for (const auto& clue : seq) {
+      put_varint(buf, clue.value);
+      if (colored)
+        put_varint(buf, color_index(palette, clue.color));
+    }
+  }
+  return buf;
+}
+
+std::string& nbn_format::put_solution(std::string& buf, const Puzzle& puzzle)
+{
+  const ColorPalette& palette = puzzle.palette();
+  const int width = puzzle.width(), height = puzzle.height();
+  const std::size_t plane_size
+    = (static_cast<std::size_t>(width) * height + 7) / 8;
+
+  //one plane for each color that appears in the grid
+  std::vector<std::string> planes(palette.size() + 1);
+  std::size_t bit = 0;
+  for (int row = 0; row < height; ++row) {
+    for (int col = 0; col < width; ++col, ++bit) {
+      const PuzzleCell& cell = puzzle.at(col, row);
+      if (cell.state != PuzzleCell::State::filled)
+        continue;
+
+      std::string& plane = planes[color_index(palette, cell.color)];
+      if (plane.empty())
+        plane.assign(plane_size, '\0');
+      plane[bit / 8] |= static_cast<char>(1u << (bit % 8));
+    }
+  }
+
+  std::string section;
+  std::size_t num_planes = std::count_if(planes.begin(), planes.end(),
+                                         [](const std::string& p)
+                                         { return !p.empty(); });
+  put_varint(section, num_planes);
+  for (std::size_t i = 0; i != planes.size(); ++i) {
+    if (!planes[i].empty())
+      put_varint(section, i).append(planes[i]);
+  }
+
+  put_varint(buf, section.size());
+  return buf.append(section);
+}
+
+std::ostream& nbn_format::write(std::ostream& os, const Puzzle& puzzle)
+{
+  const ColorPalette& palette = puzzle.palette();
+  bool colored = !has_uniform_clue_color(puzzle);
+  bool solution = is_grid_solution(puzzle);
+
+  unsigned flags = 0;
+  if (puzzle.is_multicolor())
+    flags |= multicolor;
+  if (colored)
+    flags |= colored_clues;
+  if (solution)
+    flags |= has_solution;
+
+  auto property = [&puzzle](const std::string& name) {
+    const std::string* val = puzzle.find_property(name);
+    return val ? *val : std::string();
+  };
+
+  std::string header;
+  put_varint(header, puzzle.width());
+  put_varint(header, puzzle.height());
+  put_string(header, property("title"));
+  put_string(header, property("by"));
+  put_string(header, property("collection"));
+  put_string(header, property("id"));
+
+  std::string buf(magic, sizeof(magic));
+  buf.push_back(static_cast<char>(version));
+  buf.push_back(static_cast<char>(flags));
+  put_varint(buf, header.size()).append(header);
+
+  put_varint(buf, puzzle.properties().size());
+  for (const auto& p : puzzle.properties()) {
+    put_string(buf, p.first);
+    put_string(buf, p.second);
+  }
+
+  put_varint(buf, palette.size());
+  for (const auto& entry : palette) {
+    buf.push_back(static_cast<char>(entry.color.red()));
+    buf.push_back(static_cast<char>(entry.color.green()));
+    buf.push_back(static_cast<char>(entry.color.blue()));
+    buf.push_back(entry.symbol);
+    put_string(buf, entry.name);
+  }
+
+  if (!colored) {
+    Color clue_color;
+    if (!puzzle.row_clues().empty() && !puzzle.row_clues()[0].empty())
+      clue_color = puzzle.row_clues()[0][0].color;
+    put_varint(buf, color_index(palette, clue_color));
+  }
+
+  put_clues(buf, puzzle.row_clues(), palette, colored);
+  put_clues(buf, puzzle.col_clues(), palette, colored);
+
+  if (solution)
+    put_solution(buf, puzzle);
+
+  return os.write(buf.data(), buf.size());
+}
+
+/*
+ * Read the magic number, version, flags, and header bytes. This is
+ * all that is touched when skimming.
+ */
+std::istream& nbn_format::read_prefix(std::istream& is, unsigned& flags,
+                                      std::string& header)
+{
+  char prefix[sizeof(magic) + 2];
+  if (!is.read(prefix, sizeof(prefix))
+      || std::memcmp(prefix, magic, sizeof(magic)) != 0)
+    throw InvalidPuzzleFile("nbn_format::read_prefix: "
+                            "not an nbn puzzle file");
+
+  if (prefix[sizeof(magic)] != version)
+    throw UnsupportedFeature("nbn_format::read_prefix: "
+                             "unsupported nbn version "
+                             + std::to_string(prefix[sizeof(magic)]));
+  flags = static_cast<unsigned char>(prefix[sizeof(magic) + 1]);
+
+  std::uint64_t header_size = read_varint(is);
+  if (header_size > 0xffff)
+    throw InvalidPuzzleFile("nbn_format::read_prefix: "
+                            "invalid header size");
+
+  header.resize(static_cast<std::size_t>(header_size));
+  if (!is.read(&header[0], header.size()))
+    throw InvalidPuzzleFile("nbn_format::read_prefix: "
+                            "unexpected end of file");
+  return is;
+}
+
+int nbn_format::read_dimension(ByteReader& rd)
+{
+  //keep width * height well within the range of an int
+  std::uint64_t value = rd.varint();
+  if (value > 0x7fff)
+    throw InvalidPuzzleFile("nbn_format::read_dimension: "
+                            "puzzle dimensions are too large");
+  return static_cast<int>(value);
+}
+
+void nbn_format::read_header(ByteReader& rd, int& width, int& height,
+                             PuzzleSummary* summary)
+{
+  width = read_dimension(rd);
+  height = read_dimension(rd);
+
+  if (summary) {
+    summary->width = width;
+    summary->height = height;
+    summary->title = rd.string();
+    summary->author = rd.string();
+    summary->collection = rd.string();
+    summary->id = rd.string();
+  }
+}
+
+const Color& nbn_format::lookup_color(const std::vector<Color>& colors,
+                                      std::uint64_t index)
+{
+  if (index >= colors.size())
+    throw InvalidPuzzleFile("nbn_format::lookup_color: "
+                            "color index out of range");
+  return colors[static_cast<std::size_t>(index)];
+}
+
+void nbn_format::read_clues(ByteReader& rd, Puzzle::ClueContainer& clues,
+                            int count, const std::vector<Color>& colors,
+                            bool colored, const Color& clue_color)
+{
+  clues.resize(count);
+  for (auto& seq : clues) {
+    std::uint64_t num_clues = rd.varint();
+    if (num_clues > 0x7fff)
+      throw InvalidPuzzleFile("nbn_format::read_clues: "
+                              "too many clues in line");
+
+    seq.resize(static_cast<std::size_t>(num_clues));
+    for (auto& clue : seq) {
+      std::uint64_t value = rd.varint();
+      if (value > 0x7fff)
+        throw InvalidPuzzleFile("nbn_format::read_clues: "
+                                "invalid clue value");
+      clue.value = static_cast<int>(value);
+      clue.color = colored ? lookup_color(colors, rd.varint()) : clue_color;
+    }
+  }
+}
+
+std::istream& nbn_format::read(std::istream& is, PuzzleBlueprint& blueprint)
+{
+  unsigned flags = 0;
+  std::string header;
+  read_prefix(is, flags, header);
+
+  ByteReader hrd(header);
+  read_header(hrd, blueprint.width, blueprint.height, nullptr);
+
+  //slurp the remainder of the file in large blocks
+  std::string body;
+  char block[16384];
+  while (is.read(block, sizeof(block)) || is.gcount() > 0)
+    body.append(block, static_cast<std::size_t>(is.gcount()));
+  is.clear(is.rdstate() & ~(std::ios::failbit | std::ios::eofbit));
+
+  ByteReader rd(body);
+
+  for (std::uint64_t n = rd.varint(); n > 0; --n) {
+    std::string name = rd.string();
+    blueprint.properties[name] = rd.string();
+  }
+
+  //index 0 is reserved for the default color
+  std::vector<Color> colors(1);
+  for (std::uint64_t n = rd.varint(); n > 0; --n) {
+    int r = rd.byte(), g = rd.byte(), b = rd.byte();
+    char symbol = static_cast<char>(rd.byte());
+    Color color(r, g, b);
+    blueprint.palette.add(color, rd.string(), symbol);
+    colors.push_back(color);
+  }
+
+  bool colored = flags & colored_clues;
+  Color clue_color;
+  if (!colored)
+    clue_color = lookup_color(colors, rd.varint());
+
+  read_clues(rd, blueprint.row_clues, blueprint.height, colors,
+             colored, clue_color);
+  read_clues(rd, blueprint.col_clues, blueprint.width, colors,
+             colored, clue_color);
+
+  //the solution is not needed to play the puzzle
+  if (flags & has_solution)
+    rd.skip(rd.varint());
+
+  return is;
+}
+
+std::istream& nbn_format::skim(std::istream& is, PuzzleSummary& summary)
+{
+  try {
+    unsigned flags = 0;
+    std::string header;
+    read_prefix(is, flags, header);
+
+    ByteReader rd(header);
+    int width, height;
+    read_header(rd, width, height, &summary);
+    summary.is_multicolor = flags & multicolor;
+  } catch (const std::exception&) { } //ignore file errors
+
+  return is;
+}
@@ -0,0 +1,377 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "puzzle/puzzle_pack.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <experimental/filesystem>
+#include "puzzle/puzzle.hpp"
+#include "utility/binary_io.hpp"
+#include "utility/utility.hpp"
+
+namespace stdfs = std::experimental::filesystem;
+
+/*
+ * File layout:
+ *
+ *   magic        "NPK\x1a"
+ *   version      1 byte
+ *   reserved     3 bytes
+ *   toc offset   8 bytes, little-endian
+ *   bodies       puzzle files, back to back
+ *   contents     entry count, then for each entry its name, format,
+ *                offset, size, and summary fields
+ *
+ * Superseded tables of contents are left in place as dead space until
+ * the pack is compacted.
+ */
+namespace {
+  const char pack_magic[] = { 'N', 'P', 'K', '\x1a' };
+  constexpr int pack_version = 1;
+  constexpr int header_size = 16;
+  constexpr std::size_t toc_offset_pos = 8;
+
+  std::string pack_header(std::uint64_t toc_offset)
+  {
+    std::string header(pack_magic, sizeof(pack_magic));
+    header.push_back(static_cast<char>(pack_version));
+    header.append(3, '\0');
+    put_uint64(header, toc_offset);
+    return header;
+  }
+}
+
+PuzzlePack::PuzzlePack(const std::string& filename, bool create)
+{
+  open(filename, create);
+}
+
+void PuzzlePack::open(const std::string& filename, bool create)
+{
+  m_filename = filename;
+  m_entries.clear();
+  m_index.clear();
+  m_pending.clear();
+  m_pending_data.clear();
+  m_file_size = m_contents_size = 0;
+
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    if (create && !stdfs::exists(filename))
+      return;
+    throw std::runtime_error("PuzzlePack::open: could not open pack file "
+                             + filename);
+  }
+
+  read_contents(file);
+}
+
+void PuzzlePack::read_contents(std::istream& is)
+{
+  std::string header(header_size, '\0');
+  if (!is.read(&header[0], header_size)
+      || std::memcmp(header.data(), pack_magic, sizeof(pack_magic)) != 0)
+    throw InvalidPuzzleFile("PuzzlePack::read_contents: "
+                            "not a puzzle pack");
+  if (header[sizeof(pack_magic)] != pack_version)
+    throw UnsupportedFeature("PuzzlePack::read_contents: "
+                             "unsupported pack version");
+
+  ByteReader hrd(header);
+  hrd.skip(toc_offset_pos);
+  std::uint64_t toc_offset = hrd.uint64();
+
+  //read the table of contents in one go
+  is.seekg(0, std::ios::end);
+  std::uint64_t file_size = is.tellg();
+  if (toc_offset < header_size || toc_offset > file_size)
+    throw InvalidPuzzleFile("PuzzlePack::read_contents: "
+                            "invalid table of contents offset");
+
+  std::string toc(file_size - toc_offset, '\0');
+  is.seekg(toc_offset);
+  if (!toc.empty() && !is.read(&toc[0], toc.size()))
+    throw InvalidPuzzleFile("PuzzlePack::read_contents: "
+                            "could not read table of contents");
+
+  m_file_size = file_size;
+  m_contents_size = toc.size();
+
+  ByteReader rd(toc);
+  std::uint64_t count = rd.varint();
+  for (std::uint64_t i = 0; i < count; ++i) {
+    Entry e;
+    e.name = rd.string();
+    int format = rd.byte();
+    if (format < static_cast<int>(PuzzleFormat::non)
+        || format > static_cast<int>(PuzzleFormat::nbn)
+        || format == static_cast<int>(PuzzleFormat::png))
+      throw InvalidPuzzleFile("PuzzlePack::read_contents: "
+                              "entry " + e.name + " has an invalid format");
+    e.format = static_cast<PuzzleFormat>(format);
+    e.offset = rd.varint();
+    e.size = rd.varint();
+    e.summary.width = static_cast<int>(rd.varint());
+    e.summary.height = static_cast<int>(rd.varint());
+    e.summary.title = rd.string();
+    e.summary.author = rd.string();
+    e.summary.collection = rd.string();
+    e.summary.id = rd.string();
+    e.summary.is_multicolor = rd.byte() != 0;
+
+    if (e.offset < header_size || e.size > toc_offset
+        || e.offset > toc_offset - e.size)
+      throw InvalidPuzzleFile("PuzzlePack::read_contents: "
+                              "entry " + e.name + " is out of range");
+    add_entry(e);
+  }
+}
+
+void PuzzlePack::add_entry(const Entry& entry)
+{
+  auto it = m_index.find(entry.name);
+  if (it != m_index.end()) {
+    m_entries[it->second] = entry;
+  } else {
+    m_index[entry.name] = m_entries.size();
+    m_entries.push_back(entry);
+  }
+}
+
+PuzzlePack::const_iterator PuzzlePack::find(const std::string& name) const
+{
+  auto it = m_index.find(name);
+  if (it == m_index.end())
+    return end();
+  return m_entries.begin() + it->second;
+}
+
+void PuzzlePack::read(const Entry& entry, Puzzle& puzzle) const
+{
+  std::ifstream file(m_filename, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("PuzzlePack::read: could not open pack file "
+                             + m_filename);
+
+  std::string body(entry.size, '\0');
+  file.seekg(entry.offset);
+  if (!body.empty() && !file.read(&body[0], body.size()))
+    throw InvalidPuzzleFile("PuzzlePack::read: could not read puzzle "
+                            + entry.name);
+
+  std::istringstream ss(body);
+  read_puzzle(ss, puzzle, entry.format);
+}
+
+void PuzzlePack::append(const std::string& name, const Puzzle& puzzle,
+                        PuzzleFormat fmt)
+{
+  if (fmt == PuzzleFormat::png)
+    throw UnsupportedFeature("PuzzlePack::append: "
+                             "images cannot be stored in a pack");
+
+  std::ostringstream os;
+  write_puzzle(os, puzzle, fmt);
+  std::string body = os.str();
+
+  Entry e;
+  e.name = name;
+  e.format = fmt;
+  e.offset = m_pending_data.size(); //relative until committed
+  e.size = body.size();
+
+  std::istringstream ss(body);
+  skim_puzzle(ss, e.summary, fmt);
+
+  m_pending_data += body;
+  m_pending.push_back(std::move(e));
+}
+
+void PuzzlePack::commit()
+{
+  if (m_pending.empty() && stdfs::exists(m_filename))
+    return;
+
+  std::fstream file;
+  std::uint64_t data_start = header_size;
+  if (stdfs::exists(m_filename)) {
+    file.open(m_filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(0, std::ios::end);
+    data_start = file.tellp();
+  } else {
+    file.open(m_filename, std::ios::out | std::ios::binary);
+    std::string header = pack_header(header_size);
+    file.write(header.data(), header.size());
+  }
+
+  if (!file)
+    throw std::runtime_error("PuzzlePack::commit: could not write to "
+                             "pack file " + m_filename);
+
+  for (auto& e : m_pending) {
+    e.offset += data_start;
+    add_entry(e);
+  }
+
+  std::string toc = contents(m_entries);
+  file.write(m_pending_data.data(), m_pending_data.size());
+  file.write(toc.data(), toc.size());
+  file.flush();
+
+  //only point to the new contents once everything else is written
+  std::string offset;
+  put_uint64(offset, data_start + m_pending_data.size());
+  file.seekp(toc_offset_pos);
+  file.write(offset.data(), offset.size());
+  file.flush();
+
+  if (!file)
+    throw std::runtime_error("PuzzlePack::commit: could not write to "
+                             "pack file " + m_filename);
+
+  m_file_size = data_start + m_pending_data.size() + toc.size();
+  m_contents_size = toc.size();
+  m_pending.clear();
+  m_pending_data.clear();
+
+  //repeated commits would otherwise grow the file quadratically
+  if (wasted_space() > m_file_size / 2)
+    compact();
+}
+
+void PuzzlePack::compact()
+{
+  commit();
+  if (wasted_space() == 0)
+    return;
+
+  std::ifstream in(m_filename, std::ios::in | std::ios::binary);
+  if (!in.is_open())
+    throw std::runtime_error("PuzzlePack::compact: could not open pack "
+                             "file " + m_filename);
+
+  //build the new file next to the old one and swap it in at the end
+  std::string temp_filename = m_filename + ".tmp";
+  std::vector<Entry> entries = m_entries;
+  std::string toc;
+  {
+    std::ofstream out(temp_filename, std::ios::out | std::ios::binary);
+    if (!out.is_open())
+      throw std::runtime_error("PuzzlePack::compact: could not write to "
+                               + temp_filename);
+
+    std::string header = pack_header(header_size);
+    out.write(header.data(), header.size());
+
+    std::uint64_t offset = header_size;
+    std::string body;
+    for (auto& e : entries) {
+      body.resize(e.size);
+      in.seekg(e.offset);
+      if (!body.empty() && !in.read(&body[0], body.size()))
+        throw InvalidPuzzleFile("PuzzlePack::compact: could not read "
+                                "puzzle " + e.name);
+      out.write(body.data(), body.size());
+      e.offset = offset;
+      offset += e.size;
+    }
+
+    toc = contents(entries);
+    out.write(toc.data(), toc.size());
+
+    std::string toc_offset;
+    put_uint64(toc_offset, offset);
+    out.seekp(toc_offset_pos);
+    out.write(toc_offset.data(), toc_offset.size());
+    out.close();
+
+    if (!out) {
+      std::error_code ec;
+      stdfs::remove(temp_filename, ec);
+      throw std::runtime_error("PuzzlePack::compact: could not write to "
+                               + temp_filename);
+    }
+    m_file_size = offset + toc.size();
+  }
+
+  in.close();
+  replace_file(temp_filename, m_filename);
+  m_entries = std::move(entries);
+  m_contents_size = toc.size();
+}
+
+std::uint64_t PuzzlePack::wasted_space() const
+{
+  if (m_file_size == 0)
+    return 0;
+
+  std::uint64_t used = header_size + m_contents_size;
+  for (const auto& e : m_entries)
+    used += e.size;
+  return m_file_size > used ? m_file_size - used : 0;
+}
+
+std::string PuzzlePack::contents(const std::vector<Entry>& entries)
+{
+  std::string toc;
+  put_varint(toc, entries.size());
+  for (const auto& e : entries) {
+    put_string(toc, e.name);
+    toc.push_back(static_cast<char>(e.format));
+    put_varint(toc, e.offset);
+    put_varint(toc, e.size);
+    put_varint(toc, e.summary.width);
+    put_varint(toc, e.summary.height);
+    put_string(toc, e.summary.title);
+    put_string(toc, e.summary.author);
+    put_string(toc, e.summary.collection);
+    put_string(toc, e.summary.id);
+    toc.push_back(e.summary.is_multicolor ? 1 : 0);
+  }
+  return toc;
+}
+
+bool is_pack_file(const std::string& path)
+{
+  std::string extension = stdfs::path(path).extension().string();
+  for (auto& c : extension)
+    c = to_lower(c);
+  return extension == ".npk";
+}
+
+bool split_pack_path(const std::string& path, std::string& pack_file,
+                     std::string& entry)
+{
+  stdfs::path p(path);
+  if (!p.has_parent_path())
+    return false;
+
+  stdfs::path parent = p.parent_path();
+  if (!is_pack_file(parent.string()) || stdfs::is_directory(parent))
+    return false;
+
+  pack_file = parent.string();
+  entry = p.filename().string();
+  return true;
+}
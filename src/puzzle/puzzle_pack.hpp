@@ -0,0 +1,117 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_PUZZLE_PACK_HPP
+#define NONNY_PUZZLE_PACK_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "puzzle/puzzle_io.hpp"
+#include "puzzle/puzzle_summary.hpp"
+
+class Puzzle;
+
+/*
+ * A single-file collection of puzzles (.npk). The file begins with a
+ * small header pointing to a table of contents that lists the name,
+ * location, and summary of every puzzle, so a pack can be browsed
+ * without touching the puzzle bodies. Updates are append-only: new
+ * bodies and a new table of contents are written after the existing
+ * data and the header pointer is switched over last. A puzzle appended
+ * under an existing name replaces the older entry. Once superseded
+ * data makes up most of the file, commit rewrites it without them.
+ */
+class PuzzlePack {
+public:
+  struct Entry {
+    std::string name;
+    PuzzleFormat format = PuzzleFormat::nbn;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    PuzzleSummary summary;
+  };
+  typedef std::vector<Entry>::const_iterator const_iterator;
+
+  PuzzlePack() = default;
+  explicit PuzzlePack(const std::string& filename, bool create = false);
+
+  /*
+   * Read the table of contents of a pack file. If create is true, a
+   * missing file is treated as an empty pack and is written on the
+   * first commit.
+   */
+  void open(const std::string& filename, bool create = false);
+
+  const std::string& filename() const { return m_filename; }
+
+  const_iterator begin() const { return m_entries.begin(); }
+  const_iterator end() const { return m_entries.end(); }
+  std::vector<Entry>::size_type size() const { return m_entries.size(); }
+
+  // Find an entry by name, returns end() if not found
+  const_iterator find(const std::string& name) const;
+
+  // Load the puzzle stored in the given entry
+  void read(const Entry& entry, Puzzle& puzzle) const;
+
+  /*
+   * Queue a puzzle to be added to the pack. Bodies are stored in the
+   * compact .nbn encoding unless another format is requested. Nothing
+   * is written until commit is called.
+   */
+  void append(const std::string& name, const Puzzle& puzzle,
+              PuzzleFormat fmt = PuzzleFormat::nbn);
+
+  // Write queued puzzles and a new table of contents to the file
+  void commit();
+
+  // Rewrite the file with only the current entries and contents
+  void compact();
+
+  // Bytes taken up by superseded puzzles and tables of contents
+  std::uint64_t wasted_space() const;
+
+private:
+  void read_contents(std::istream& is);
+  void add_entry(const Entry& entry);
+  static std::string contents(const std::vector<Entry>& entries);
+
+  std::string m_filename;
+  std::vector<Entry> m_entries;
+  std::map<std::string, std::size_t> m_index;
+  std::vector<Entry> m_pending;
+  std::string m_pending_data;
+  std::uint64_t m_file_size = 0;
+  std::uint64_t m_contents_size = 0;
+};
+
+// Determine whether a file is a puzzle pack, based on its extension
+bool is_pack_file(const std::string& path);
+
+/*
+ * Split a path like "collection.npk/puzzle" into the pack file and the
+ * entry name. Returns false if the path does not point inside a pack.
+ */
+bool split_pack_path(const std::string& path, std::string& pack_file,
+                     std::string& entry);
+
+#endif
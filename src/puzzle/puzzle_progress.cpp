@@ -20,14 +20,27 @@
 
 #include "puzzle/puzzle_progress.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
 #include "puzzle/puzzle.hpp"
 #include "puzzle/puzzle_grid.hpp"
+#include "puzzle/puzzle_io.hpp"
+#include "utility/binary_io.hpp"
 #include "utility/utility.hpp"
 
 void PuzzleProgress::store_progress(const Puzzle& puzzle, unsigned time,
                                     bool update_solution)
+{
+  store_progress(puzzle.grid(), time, update_solution);
+}
+
+void PuzzleProgress::store_progress(PuzzleGrid grid, unsigned time,
+                                    bool update_solution)
 {
   if (update_solution) {
     m_completed = true;
@@ -39,13 +52,10 @@ void PuzzleProgress::store_progress(const Puzzle& puzzle, unsigned time,
 
   //reset progress state and then store progress or solution as needed
   m_progress = PuzzleGrid();
-  PuzzleGrid* grid = update_solution ? &m_solution : &m_progress;
-  *grid = PuzzleGrid(puzzle.width(), puzzle.height());
-  for (int y = 0; y != puzzle.height(); ++y) {
-    for (int x = 0; x != puzzle.width(); ++x) {
-      grid->at(x, y) = puzzle[x][y];
-    }
-  }
+  if (update_solution)
+    m_solution = std::move(grid);
+  else
+    m_progress = std::move(grid);
 }
 
 void PuzzleProgress::restore_progress(Puzzle& puzzle) const
@@ -73,44 +83,247 @@ void PuzzleProgress::restore(Puzzle& puzzle, const PuzzleGrid& grid) const
   }
 }
 
-std::ostream& operator<<(std::ostream& os, const PuzzleProgress& prog)
+/*
+ * Progress files are binary:
+ *
+ *   magic        "NSV\x1a"
+ *   version      1 byte
+ *   file         string
+ *   completed    1 byte
+ *   best_time    varint
+ *   time         varint
+ *   solution     grid, only present if completed
+ *   progress     grid
+ *
+ * A grid is stored as its width and height, a table of the colors
+ * used, and a run-length encoding of the cells in row-major order.
+ * Each run is a length followed by a cell code: 0 for blank, 1 for
+ * crossed out, or 2 + n for a cell filled with color n. Older text
+ * files are still read.
+ */
+namespace {
+  const char progress_magic[] = { 'N', 'S', 'V', '\x1a' };
+  constexpr int progress_version = 1;
+
+  enum CellCode : unsigned { blank_code = 0, crossed_code = 1, color_code = 2 };
+
+  std::uint32_t pack_color(const Color& c)
+  {
+    return c.red() << 16 | c.green() << 8 | c.blue();
+  }
+
+  void put_grid(std::string& buf, const PuzzleGrid& grid)
+  {
+    const int width = grid.width(), height = grid.height();
+
+    //runs are encoded first so the color table is known
+    std::unordered_map<std::uint32_t, unsigned> color_index;
+    std::vector<Color> colors;
+    std::string runs;
+    std::size_t num_runs = 0;
+
+    //the current run, which may continue onto the next row
+    const PuzzleCell* first = nullptr;
+    int length = 0;
+    auto end_run = [&]() {
+      unsigned code = blank_code;
+      if (first->state == PuzzleCell::State::crossed_out)
+        code = crossed_code;
+      else if (first->state == PuzzleCell::State::filled) {
+        auto ins = color_index.emplace(pack_color(first->color),
+                                       colors.size());
+        if (ins.second)
+          colors.push_back(first->color);
+        code = color_code + ins.first->second;
+      }
+
+      put_varint(runs, length);
+      put_varint(runs, code);
+      ++num_runs;
+    };
+
+    for (int y = 0; y < height; ++y) {
+      const PuzzleCell* row = grid.row(y);
+      for (int x = 0; x < width; ++x) {
+        //colors of unfilled cells don't matter
+        const PuzzleCell& cell = row[x];
+        if (first && cell.state == first->state
+            && (cell.state != PuzzleCell::State::filled
+                || cell.color == first->color)) {
+          ++length;
+          continue;
+        }
+
+        if (first)
+          end_run();
+        first = &cell;
+        length = 1;
+      }
+    }
+    if (first)
+      end_run();
+
+    put_varint(buf, width);
+    put_varint(buf, height);
+    put_varint(buf, colors.size());
+    for (const auto& c : colors) {
+      buf.push_back(static_cast<char>(c.red()));
+      buf.push_back(static_cast<char>(c.green()));
+      buf.push_back(static_cast<char>(c.blue()));
+    }
+    put_varint(buf, num_runs);
+    buf.append(runs);
+  }
+
+  PuzzleGrid read_grid(ByteReader& rd)
+  {
+    std::uint64_t width = rd.varint(), height = rd.varint();
+    if (width > 0x7fff || height > 0x7fff)
+      throw InvalidPuzzleFile("::read_grid: invalid grid size");
+
+    std::vector<Color> colors(static_cast<std::size_t>(rd.varint()));
+    for (auto& c : colors) {
+      int r = rd.byte(), g = rd.byte(), b = rd.byte();
+      c = Color(r, g, b);
+    }
+
+    PuzzleGrid grid(static_cast<int>(width), static_cast<int>(height));
+    const std::uint64_t size = width * height;
+    std::uint64_t pos = 0;
+    int x = 0, y = 0; //position of cell pos
+    for (std::uint64_t n = rd.varint(); n > 0; --n) {
+      std::uint64_t length = rd.varint();
+      std::uint64_t code = rd.varint();
+      if (length > size - pos)
+        throw InvalidPuzzleFile("::read_grid: invalid puzzle state");
+
+      PuzzleCell cell;
+      if (code == crossed_code)
+        cell.state = PuzzleCell::State::crossed_out;
+      else if (code >= color_code) {
+        if (code - color_code >= colors.size())
+          throw InvalidPuzzleFile("::read_grid: invalid color index");
+        cell.state = PuzzleCell::State::filled;
+        cell.color = colors[static_cast<std::size_t>(code - color_code)];
+      }
+
+      //fill the run a row at a time
+      pos += length;
+      while (length > 0) {
+        int count = static_cast<int>(std::min<std::uint64_t>(length,
+                                                             width - x));
+        PuzzleCell* row = grid.row(y);
+        std::fill(row + x, row + x + count, cell);
+        length -= count;
+        x += count;
+        if (x == static_cast<int>(width)) {
+          x = 0;
+          ++y;
+        }
+      }
+    }
+
+    return grid;
+  }
+
+  bool is_binary_progress(std::istream& is)
+  {
+    char magic[sizeof(progress_magic)];
+    bool result = is.read(magic, sizeof(magic))
+      && std::memcmp(magic, progress_magic, sizeof(magic)) == 0;
+
+    //rewind so the caller can read the file as text instead
+    is.clear();
+    is.seekg(0);
+    return result;
+  }
+}
+
+std::string read_progress_filename(std::istream& is)
 {
-  os << "file \"" << unescape(prog.m_filename) << "\"\n"
-     << "completed " << (prog.m_completed ? "yes" : "no") << "\n";
+  if (!is_binary_progress(is)) {
+    std::string line;
+    while (std::getline(is, line)) {
+      auto prop = parse_property(line);
+      if (prop.first == "file")
+        return prop.second;
+    }
+    return "";
+  }
 
-  os << "best_time \"";
-  write_time(os, prog.m_best_time, true) << "\"\n";
+  is.seekg(sizeof(progress_magic) + 1);
+  std::uint64_t len = read_varint(is);
+  if (len > 0xffff)
+    throw InvalidPuzzleFile("::read_progress_filename: invalid filename");
 
-  os << "time \"";
-  write_time(os, prog.m_cur_time, true) << "\"\n";
+  std::string filename(static_cast<std::size_t>(len), '\0');
+  if (len && !is.read(&filename[0], filename.size()))
+    throw InvalidPuzzleFile("::read_progress_filename: "
+                            "unexpected end of file");
+  return filename;
+}
+
+std::ostream& operator<<(std::ostream& os, const PuzzleProgress& prog)
+{
+  std::string buf(progress_magic, sizeof(progress_magic));
+  buf.push_back(static_cast<char>(progress_version));
+  put_string(buf, prog.m_filename);
+  buf.push_back(prog.m_completed ? 1 : 0);
+  put_varint(buf, prog.m_best_time);
+  put_varint(buf, prog.m_cur_time);
 
   if (prog.m_completed)
-    os << "solution\n" << prog.solution() << "\n";
+    put_grid(buf, prog.m_solution);
+  put_grid(buf, prog.m_progress);
 
-  os << "progress\n" << prog.state() << "\n";
-  return os;
+  return os.write(buf.data(), buf.size());
 }
 
 std::istream& operator>>(std::istream& is, PuzzleProgress& prog)
 {
-  std::string line;
-  while (std::getline(is, line)) {
-    auto p = parse_property(line);
-    if (p.first == "file")
-      prog.m_filename = p.second;
-    else if (p.first == "completed") {
-      if (p.second == "yes")
-        prog.m_completed = true;
-      else
-        prog.m_completed = false;
-    } else if (p.first == "best_time")
-      prog.m_best_time = string_to_time(p.second);
-    else if (p.first == "time")
-      prog.m_cur_time = string_to_time(p.second);
-    else if (p.first == "solution")
-      is >> prog.m_solution;
-    else if (p.first == "progress")
-      is >> prog.m_progress;
+  if (!is_binary_progress(is)) { //older text format
+    std::string line;
+    while (std::getline(is, line)) {
+      auto p = parse_property(line);
+      if (p.first == "file")
+        prog.m_filename = p.second;
+      else if (p.first == "completed") {
+        if (p.second == "yes")
+          prog.m_completed = true;
+        else
+          prog.m_completed = false;
+      } else if (p.first == "best_time")
+        prog.m_best_time = string_to_time(p.second);
+      else if (p.first == "time")
+        prog.m_cur_time = string_to_time(p.second);
+      else if (p.first == "solution")
+        is >> prog.m_solution;
+      else if (p.first == "progress")
+        is >> prog.m_progress;
+    }
+    return is;
   }
+
+  std::string buf;
+  char block[16384];
+  while (is.read(block, sizeof(block)) || is.gcount() > 0)
+    buf.append(block, static_cast<std::size_t>(is.gcount()));
+
+  ByteReader rd(buf);
+  rd.skip(sizeof(progress_magic));
+  if (rd.byte() != progress_version)
+    throw UnsupportedFeature("::operator>>: unsupported progress "
+                             "file version");
+
+  prog.m_filename = rd.string();
+  prog.m_completed = rd.byte() != 0;
+  prog.m_best_time = static_cast<unsigned>(rd.varint());
+  prog.m_cur_time = static_cast<unsigned>(rd.varint());
+
+  if (prog.m_completed)
+    prog.m_solution = read_grid(rd);
+  prog.m_progress = read_grid(rd);
+
+  is.clear(is.rdstate() & ~(std::ios::failbit | std::ios::eofbit));
   return is;
 }
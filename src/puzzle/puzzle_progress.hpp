@@ -36,7 +36,9 @@ class Puzzle;
  * time.
  *
  * Progress can be loaded and saved from streams by using the << and
- * >> operators.
+ * >> operators. Progress is written in a compact binary format, but
+ * files in the older text format can still be read. Streams should be
+ * opened in binary mode and must be seekable.
  */
 class PuzzleProgress {
   friend std::ostream& operator<<(std::ostream&, const PuzzleProgress&);
@@ -58,6 +60,8 @@ public:
    */
   void store_progress(const Puzzle& puzzle, unsigned time,
                       bool update_solution = false);
+  void store_progress(PuzzleGrid grid, unsigned time,
+                      bool update_solution = false);
 
   // Restore saved progress on a puzzle
   void restore_progress(Puzzle& puzzle) const;
@@ -90,6 +94,9 @@ private:
 std::ostream& operator<<(std::ostream&, const PuzzleProgress&);
 std::istream& operator>>(std::istream&, PuzzleProgress&);
 
+// Read just the puzzle filename stored in a progress file
+std::string read_progress_filename(std::istream& is);
+
 
 /* implementation */
 
@@ -24,14 +24,15 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <utility>
 #include <experimental/filesystem>
+#include "puzzle/puzzle.hpp"
 #include "puzzle/puzzle_progress.hpp"
 #include "settings/game_settings.hpp"
 #include "utility/utility.hpp"
 
 namespace stdfs = std::experimental::filesystem;
 
-std::istream& scan_for_path(std::istream& is, std::string& path);
 std::string standardize(const std::string& name);
 
 constexpr int max_id_size = 32;
@@ -42,41 +43,154 @@ SaveManager::SaveManager(GameSettings& settings)
 {
 }
 
+SaveManager::~SaveManager()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+  m_cond.notify_all();
+
+  //the worker drains the queue before exiting
+  if (m_worker.joinable())
+    m_worker.join();
+}
+
 void SaveManager::load_progress(PuzzleProgress& prog,
                                 const std::string& path,
                                 const std::string& collection,
                                 const std::string& id) const
 {
-  std::string filename = find_save_file(path, collection, id);
-  std::ifstream file(filename);
+  flush();
+  read_progress(prog, path, collection, id);
+}
 
-  if (file.is_open()) {
-    file >> prog;
-  } else {
-    prog = PuzzleProgress(path);
+void SaveManager::save_progress(const PuzzleProgress& prog,
+                                const std::string& path,
+                                const std::string& collection,
+                                const std::string& id) const
+{
+  flush();
+  write_progress(prog, path, collection, id);
+}
+
+void SaveManager::queue_progress(const Puzzle& puzzle, unsigned time,
+                                 bool just_completed,
+                                 const std::string& path,
+                                 const std::string& collection,
+                                 const std::string& id)
+{
+  SaveJob job;
+  job.grid = puzzle.grid();
+  job.time = time;
+  job.just_completed = just_completed;
+  job.collection = collection;
+  job.id = id;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue[path] = std::move(job);
+    if (!m_worker.joinable())
+      m_worker = std::thread(&SaveManager::run_worker, this);
   }
+  m_cond.notify_all();
 }
 
-void SaveManager::save_progress(const PuzzleProgress& prog,
+void SaveManager::flush() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait(lock, [this]() { return m_queue.empty() && !m_writing; });
+}
+
+void SaveManager::read_progress(PuzzleProgress& prog,
                                 const std::string& path,
                                 const std::string& collection,
                                 const std::string& id) const
 {
   std::string filename = find_save_file(path, collection, id);
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+  prog = PuzzleProgress(path);
+  if (file.is_open()) {
+    try {
+      file >> prog;
+    } catch (const std::exception&) {
+      prog = PuzzleProgress(path); //ignore damaged save files
+    }
+  }
+}
+
+void SaveManager::write_progress(const PuzzleProgress& prog,
+                                 const std::string& path,
+                                 const std::string& collection,
+                                 const std::string& id) const
+{
+  std::string filename = find_save_file(path, collection, id);
 
   //make sure directory exists, create it if not
   stdfs::path p = stdfs::path(filename).remove_filename();
   if (!p.empty() && !stdfs::exists(p))
     stdfs::create_directories(p);
 
-  std::ofstream file(filename);
+  //write to a temporary file first so a failed or interrupted write
+  //never leaves a truncated save behind
+  std::string temp_filename = filename + ".tmp";
+  {
+    std::ofstream file(temp_filename, std::ios::out | std::ios::binary);
+
+    if (!file.is_open())
+      throw std::runtime_error("SaveManager::save_progress: "
+                               "could not save to file "
+                               + filename);
+
+    file << prog;
+    file.close();
+    if (!file) {
+      std::error_code ec;
+      stdfs::remove(temp_filename, ec);
+      throw std::runtime_error("SaveManager::save_progress: "
+                               "error writing to file "
+                               + filename);
+    }
+  }
+
+  replace_file(temp_filename, filename);
+}
+
+void SaveManager::write_job(const std::string& path, SaveJob& job) const
+{
+  PuzzleProgress prog;
+  read_progress(prog, path, job.collection, job.id);
+  prog.store_progress(std::move(job.grid), job.time, job.just_completed);
+  write_progress(prog, path, job.collection, job.id);
+}
+
+void SaveManager::run_worker()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this]() { return m_quit || !m_queue.empty(); });
+    if (m_queue.empty())
+      break; //quitting with nothing left to write
+
+    auto it = m_queue.begin();
+    std::string path = it->first;
+    SaveJob job = std::move(it->second);
+    m_queue.erase(it);
+    m_writing = true;
+    lock.unlock();
 
-  if (!file.is_open())
-    throw std::runtime_error("SaveManager::save_progress: "
-                             "could not save to file "
-                             + filename);
+    try {
+      write_job(path, job);
+    } catch (const std::exception& e) {
+      //an autosave failing is not fatal, the next save will retry
+      std::cerr << e.what() << std::endl;
+    }
 
-  file << prog;
+    lock.lock();
+    m_writing = false;
+    m_cond.notify_all();
+  }
 }
 
 std::string SaveManager::find_save_file(const std::string& path,
@@ -103,10 +217,12 @@ std::string SaveManager::find_save_file(const std::string& path,
     else
       full_name += std_id + std::to_string(counter) + ".nsv";
 
-    std::ifstream file(full_name);
+    std::ifstream file(full_name, std::ios::in | std::ios::binary);
     if (file.is_open()) {
       std::string name;
-      scan_for_path(file, name);
+      try {
+        name = read_progress_filename(file);
+      } catch (const std::exception&) { }
       if (name == path)
         return full_name;
     } else
@@ -119,21 +235,6 @@ std::string SaveManager::find_save_file(const std::string& path,
   return expected_dir + std_id + ".nsv";
 }
 
-std::istream& scan_for_path(std::istream& is, std::string& path)
-{
-  path = "";
-  std::string line;
-  while (std::getline(is, line)) {
-    auto prop = parse_property(line);
-
-    if (prop.first == "file") {
-      path = prop.second;
-      break;
-    }
-  }
-  return is;
-}
-
 std::string standardize(const std::string& name)
 {
   std::string result;
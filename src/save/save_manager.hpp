@@ -21,20 +21,33 @@
 #ifndef NONNY_SAVE_MANAGER_HPP
 #define NONNY_SAVE_MANAGER_HPP
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include "puzzle/puzzle_grid.hpp"
 
 class GameSettings;
+class Puzzle;
 class PuzzleProgress;
 
 /*
  * Handles saving and loading of puzzle progress. Progress is saved
  * and loaded from a file whose filename and directory is based on the
  * name of the puzzle and the collection it belongs to, if any.
+ *
+ * Files are written atomically: output goes to a temporary file that
+ * is renamed over the old save only once it is complete.
+ * Autosaves can be queued with queue_progress; the cells are copied
+ * immediately and the file is written later on a background thread.
+ * Queued saves for the same puzzle are coalesced so that only the
+ * newest one is written.
  */
 class SaveManager {
 public:
   explicit SaveManager(GameSettings& settings);
+  ~SaveManager();
   SaveManager(const SaveManager&) = delete;
   SaveManager(SaveManager&&) = delete;
 
@@ -50,12 +63,53 @@ public:
                      const std::string& collection,
                      const std::string& id) const;
 
+  /*
+   * Snapshot the puzzle's cells and save them in the background,
+   * merged with whatever progress was previously saved for it. Any
+   * earlier save still queued for the same puzzle is replaced.
+   */
+  void queue_progress(const Puzzle& puzzle, unsigned time,
+                      bool just_completed,
+                      const std::string& path,
+                      const std::string& collection,
+                      const std::string& id);
+
+  // Block until all queued saves have been written
+  void flush() const;
+
 private:
+  struct SaveJob {
+    PuzzleGrid grid;
+    unsigned time = 0;
+    bool just_completed = false;
+    std::string collection;
+    std::string id;
+  };
+
+  void read_progress(PuzzleProgress& prog,
+                     const std::string& path,
+                     const std::string& collection,
+                     const std::string& id) const;
+  void write_progress(const PuzzleProgress& prog,
+                      const std::string& path,
+                      const std::string& collection,
+                      const std::string& id) const;
+  void write_job(const std::string& path, SaveJob& job) const;
+  void run_worker();
+
   std::string find_save_file(const std::string& path,
                              std::string collection,
                              std::string id) const;
 
   GameSettings& m_settings;
+
+  // pending saves, keyed by puzzle path
+  std::map<std::string, SaveJob> m_queue;
+  mutable std::mutex m_mutex;
+  mutable std::condition_variable m_cond;
+  bool m_writing = false;
+  bool m_quit = false;
+  std::thread m_worker;
 };
 
 #endif
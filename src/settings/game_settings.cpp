@@ -21,6 +21,7 @@
 #include "settings/game_settings.hpp"
 
 #include <fstream>
+#include <stdexcept>
 #include <experimental/filesystem>
 #include "config.h"
 #include "utility/utility.hpp"
@@ -32,6 +33,14 @@ GameSettings::GameSettings()
   find_directories();
 }
 
+void GameSettings::set_import_colors(int colors)
+{
+  if (colors < 1)
+    throw std::invalid_argument("GameSettings::set_import_colors: "
+                                "need at least one color");
+  m_import_colors = colors;
+}
+
 void GameSettings::find_directories()
 {
   m_separator = static_cast<char>(stdfs::path::preferred_separator);
@@ -41,12 +41,17 @@ public:
   inline std::string saved_progress_dir() const;
   inline std::string saved_puzzle_dir() const;
 
+  // Most colors an imported image is reduced to
+  int import_colors() const { return m_import_colors; }
+  void set_import_colors(int colors);
+
 private:
   void find_directories();
   bool is_data_dir(const std::string& path);
   std::string m_data_dir;
   std::string m_save_dir;
   char m_separator = '/';
+  int m_import_colors = 16;
 };
 
 
@@ -0,0 +1,159 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "solver/hint_task.hpp"
+
+#include "solver/line_solver.hpp"
+
+HintTask::~HintTask()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    ++m_generation;
+  }
+  m_cond.notify_all();
+
+  //a search in progress stops after its current line
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void HintTask::start(const Puzzle& puzzle)
+{
+  std::unique_ptr<Puzzle> copy(new Puzzle(puzzle));
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;
+    m_request = std::move(copy);
+    m_done = false;
+    m_rows.clear();
+    m_cols.clear();
+    m_has_hints = false;
+    if (!m_thread.joinable())
+      m_thread = std::thread(&HintTask::run_worker, this);
+  }
+  m_cond.notify_all();
+}
+
+void HintTask::cancel()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  m_request.reset();
+  m_done = true;
+  m_rows.clear();
+  m_cols.clear();
+  m_has_hints = false;
+}
+
+void HintTask::take_hints(std::vector<int>& rows, std::vector<int>& cols)
+{
+  if (!m_has_hints)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  rows.insert(rows.end(), m_rows.begin(), m_rows.end());
+  cols.insert(cols.end(), m_cols.begin(), m_cols.end());
+  m_rows.clear();
+  m_cols.clear();
+  m_has_hints = false;
+}
+
+bool HintTask::can_line_be_further_solved(PuzzleLine line, bool fast_check)
+{
+  LineSolver ls(line);
+  std::vector<PuzzleCell> result;
+
+  bool solvable = false;
+  if (fast_check)
+    solvable = ls.solve_fast(result);
+  else
+    solvable = ls.solve_complete(result);
+
+  if (!solvable)
+    return false;
+
+  //see if solver found anything
+  for (int i = 0; i < line.size(); ++i) {
+    if (result[i].state != PuzzleCell::State::blank
+        && (line[i].state != result[i].state
+            || (result[i].state == PuzzleCell::State::filled
+                && line[i].color != result[i].color)))
+      return true;
+  }
+
+  //no differences found
+  return false;
+}
+
+void HintTask::run_worker()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_cond.wait(lock, [this]() { return m_quit || m_request; });
+    if (m_quit)
+      return;
+
+    std::unique_ptr<Puzzle> puzzle = std::move(m_request);
+    unsigned generation = m_generation;
+    lock.unlock();
+
+    //if nothing was found, do an exhaustive check
+    if (!search(*puzzle, generation, true))
+      search(*puzzle, generation, false);
+
+    lock.lock();
+    if (generation == m_generation)
+      m_done = true;
+  }
+}
+
+//returns true if any hints were found
+bool HintTask::search(Puzzle& puzzle, unsigned generation, bool fast)
+{
+  bool found = false;
+  for (int i = 0; i < puzzle.width() && generation == m_generation; ++i) {
+    if (can_line_be_further_solved(puzzle.get_col(i), fast)) {
+      publish(generation, LineType::column, i);
+      found = true;
+    }
+  }
+  for (int j = 0; j < puzzle.height() && generation == m_generation; ++j) {
+    if (can_line_be_further_solved(puzzle.get_row(j), fast)) {
+      publish(generation, LineType::row, j);
+      found = true;
+    }
+  }
+  return found;
+}
+
+void HintTask::publish(unsigned generation, LineType type, int index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (generation != m_generation)
+    return; //the search was abandoned
+
+  if (type == LineType::row)
+    m_rows.push_back(index);
+  else
+    m_cols.push_back(index);
+  m_has_hints = true;
+}
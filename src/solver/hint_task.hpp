@@ -0,0 +1,85 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_HINT_TASK_HPP
+#define NONNY_HINT_TASK_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "puzzle/puzzle.hpp"
+#include "puzzle/puzzle_line.hpp"
+
+/*
+ * Looks for lines that the line solver can make progress on, working
+ * on a worker thread against a copy of the puzzle. Each line is
+ * published as soon as it is found. If the fast line solver finds
+ * nothing, the complete line solver is tried on every line.
+ *
+ * Every search has a generation number. Starting or cancelling a
+ * search only moves to a new generation; a stale search notices after
+ * its current line and its results are discarded, so the caller never
+ * waits for the worker.
+ */
+class HintTask {
+public:
+  HintTask() { }
+  HintTask(const HintTask&) = delete;
+  HintTask& operator=(const HintTask&) = delete;
+  ~HintTask();
+
+  //start searching a copy of puzzle, abandoning any earlier search
+  void start(const Puzzle& puzzle);
+
+  //abandon the current search, if any, and discard unclaimed hints
+  void cancel();
+
+  //is the worker still searching, or are there hints left to take?
+  bool is_busy() const { return !m_done || m_has_hints; }
+
+  //append the lines found since the last call
+  void take_hints(std::vector<int>& rows, std::vector<int>& cols);
+
+  // Can the line solver find new information about the line?
+  static bool can_line_be_further_solved(PuzzleLine line,
+                                         bool fast_check = true);
+
+private:
+  void run_worker();
+  bool search(Puzzle& puzzle, unsigned generation, bool fast);
+  void publish(unsigned generation, LineType type, int index);
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::unique_ptr<Puzzle> m_request; //puzzle waiting for the worker
+  std::atomic<unsigned> m_generation{0};
+  std::atomic<bool> m_done{true};
+  bool m_quit = false;
+
+  std::vector<int> m_rows;
+  std::vector<int> m_cols;
+  std::atomic<bool> m_has_hints{false};
+};
+
+#endif
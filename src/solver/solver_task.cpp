@@ -0,0 +1,125 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "solver/solver_task.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+constexpr std::chrono::milliseconds progress_interval(50);
+
+void SolverTask::start(const Puzzle& puzzle, unsigned time_limit)
+{
+  cancel();
+
+  m_puzzle.reset(new Puzzle(puzzle));
+  m_solver.reset(new Solver(*m_puzzle));
+
+  m_done = false;
+  m_cancel = false;
+  m_cancelled = false;
+  m_timed_out = false;
+  publish_progress();
+
+  m_thread = std::thread(&SolverTask::run, this, time_limit);
+}
+
+void SolverTask::cancel()
+{
+  if (m_thread.joinable()) {
+    m_cancel = true;
+    m_thread.join();
+  }
+}
+
+SolverTask::Progress SolverTask::progress() const
+{
+  Progress prog;
+  prog.known_cells = m_known_cells;
+  prog.total_cells = m_total_cells;
+  prog.num_guesses = m_num_guesses;
+  prog.search_depth = m_search_depth;
+  prog.num_solutions = m_num_solutions;
+  return prog;
+}
+
+Solver& SolverTask::solver()
+{
+  if (!is_done())
+    throw std::logic_error("SolverTask::solver: task is not done");
+  join();
+  return *m_solver;
+}
+
+Puzzle& SolverTask::puzzle()
+{
+  if (!is_done())
+    throw std::logic_error("SolverTask::puzzle: task is not done");
+  join();
+  return *m_puzzle;
+}
+
+void SolverTask::run(unsigned time_limit)
+{
+  using clock = std::chrono::steady_clock;
+  auto start_time = clock::now();
+  auto last_publish = start_time;
+
+  while (!m_solver->step() && !m_solver->was_contradiction_found()) {
+    auto now = clock::now();
+    if (m_cancel) {
+      m_cancelled = true;
+      break;
+    }
+    if (time_limit
+        && now - start_time >= std::chrono::milliseconds(time_limit)) {
+      m_timed_out = true;
+      break;
+    }
+    if (now - last_publish >= progress_interval) {
+      publish_progress();
+      last_publish = now;
+    }
+  }
+
+  publish_progress();
+  m_done = true;
+}
+
+void SolverTask::publish_progress()
+{
+  int known = 0;
+  for (int y = 0; y < m_puzzle->height(); ++y)
+    for (int x = 0; x < m_puzzle->width(); ++x)
+      if (m_puzzle->at(x, y).state != PuzzleCell::State::blank)
+        ++known;
+
+  m_known_cells = known;
+  m_total_cells = m_puzzle->width() * m_puzzle->height();
+  m_num_guesses = m_solver->num_guesses();
+  m_search_depth = m_solver->search_depth();
+  m_num_solutions = m_solver->num_solutions();
+}
+
+void SolverTask::join()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
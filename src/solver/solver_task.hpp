@@ -0,0 +1,95 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_SOLVER_TASK_HPP
+#define NONNY_SOLVER_TASK_HPP
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "puzzle/puzzle.hpp"
+#include "solver/solver.hpp"
+
+/*
+ * Runs a Solver on a worker thread against a private copy of a
+ * puzzle. Progress is published through atomics and can be read at
+ * any time; the solver and its puzzle may only be touched once the
+ * task is done.
+ */
+class SolverTask {
+public:
+  struct Progress {
+    int known_cells = 0;
+    int total_cells = 0;
+    int num_guesses = 0;
+    int search_depth = 0;
+    int num_solutions = 0;
+  };
+
+  SolverTask() { }
+  SolverTask(const SolverTask&) = delete;
+  SolverTask& operator=(const SolverTask&) = delete;
+  ~SolverTask() { cancel(); }
+
+  /*
+   * Copy the puzzle and start solving the copy. The worker gives up
+   * after time_limit milliseconds, or runs until finished if
+   * time_limit is 0. Any task already running is cancelled first.
+   */
+  void start(const Puzzle& puzzle, unsigned time_limit = 0);
+
+  //stop the worker, if any, and wait for it to exit
+  void cancel();
+
+  bool is_started() const { return m_solver != nullptr; }
+  bool is_running() const { return is_started() && !m_done; }
+  bool is_done() const { return is_started() && m_done; }
+  bool was_cancelled() const { return m_cancelled; }
+  bool timed_out() const { return m_timed_out; }
+
+  Progress progress() const;
+
+  //the finished solver and its copy of the puzzle; these throw
+  //std::logic_error while the task is still running
+  Solver& solver();
+  Puzzle& puzzle();
+
+private:
+  void run(unsigned time_limit);
+  void publish_progress();
+  void join();
+
+  std::unique_ptr<Puzzle> m_puzzle;
+  std::unique_ptr<Solver> m_solver;
+  std::thread m_thread;
+
+  std::atomic<bool> m_done{false};
+  std::atomic<bool> m_cancel{false};
+  std::atomic<bool> m_cancelled{false};
+  std::atomic<bool> m_timed_out{false};
+
+  std::atomic<int> m_known_cells{0};
+  std::atomic<int> m_total_cells{0};
+  std::atomic<int> m_num_guesses{0};
+  std::atomic<int> m_search_depth{0};
+  std::atomic<int> m_num_solutions{0};
+};
+
+#endif
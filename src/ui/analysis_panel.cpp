@@ -37,7 +37,7 @@ constexpr int button_width = 150;
 constexpr unsigned solution_cycle_duration = 1000;
 
 AnalysisPanel::AnalysisPanel(const Font& font, const Puzzle& puzzle)
-  : m_puzzle(puzzle), m_solver(m_puzzle), m_font(font)
+  : m_puzzle(puzzle), m_font(font)
 {
   setup_buttons();
   calc_size();
@@ -47,21 +47,17 @@ AnalysisPanel::AnalysisPanel(const Font& font, const Puzzle& puzzle)
 void AnalysisPanel::update(unsigned ticks, InputHandler& input,
                            const Rect& active_region)
 {
-  if (m_solver_running) {
+  if (m_solver_task.is_running()) {
     m_run_time += ticks;
-    if (m_solver.step()) {
-      m_done_solving = true;
-      m_solver_running = false;
-    } else if (m_solver.was_contradiction_found()) {
-      m_inconsistent = true;
-      m_solver_running = false;
-    }
+  } else if (m_solver_task.is_done() && !m_done_solving && !m_inconsistent) {
+    collect_results();
   }
 
-  if (m_solver.is_finished()) {
+  if (m_done_solving) {
     m_sol_cycle_time += ticks;
     if (m_sol_cycle_time >= solution_cycle_duration) {
-      m_solver.cycle_solution();
+      m_solver_task.solver().cycle_solution();
+      show_solution();
       m_sol_cycle_time = 0;
     }
   }
@@ -100,9 +96,14 @@ void AnalysisPanel::draw(Renderer& renderer, const Rect& region) const
   Rect r;
   int x = m_boundary.x() + panel_spacing;
   int y = m_boundary.y() + panel_spacing;
-  if (m_solver_running)
-    r = renderer.draw_text(Point(x, y), m_font, "Status: solving");
-  else if (m_solver.is_finished())
+  SolverTask::Progress progress = m_solver_task.progress();
+  if (m_solver_task.is_running()) {
+    int percent = 0;
+    if (progress.total_cells)
+      percent = 100 * progress.known_cells / progress.total_cells;
+    r = renderer.draw_text(Point(x, y), m_font, "Status: solving ("
+                           + std::to_string(percent) + "%)");
+  } else if (m_done_solving)
     r = renderer.draw_text(Point(x, y), m_font, "Status: solved");
   else
     r = renderer.draw_text(Point(x, y), m_font, "Status: ready");
@@ -113,9 +114,9 @@ void AnalysisPanel::draw(Renderer& renderer, const Rect& region) const
   y += r.height() + text_spacing;
 
   std::string unique_str = "Unique solution: ";
-  if (!m_solver.is_finished())
+  if (!m_done_solving)
     unique_str += "?";
-  else if (m_solver.num_solutions() == 1)
+  else if (progress.num_solutions == 1)
     unique_str += "Yes";
   else
     unique_str += "No";
@@ -123,9 +124,9 @@ void AnalysisPanel::draw(Renderer& renderer, const Rect& region) const
   y += r.height() + text_spacing;
 
   std::string lsolvable_str = "Line solvable: ";
-  if (!m_solver.is_finished())
+  if (!m_done_solving)
     lsolvable_str += "?";
-  else if (m_solver.is_line_solvable())
+  else if (m_line_solvable)
     lsolvable_str += "Yes";
   else
     lsolvable_str += "No";
@@ -133,20 +134,20 @@ void AnalysisPanel::draw(Renderer& renderer, const Rect& region) const
   y += r.height() + text_spacing;
 
   std::string depth_str;
-  if (m_solver.search_depth() > 0)
-    depth_str = "Search depth: " + std::to_string(m_solver.search_depth());
+  if (progress.search_depth > 0)
+    depth_str = "Search depth: " + std::to_string(progress.search_depth);
   if (!depth_str.empty()) {
     r = renderer.draw_text(Point(x, y), m_font, depth_str);
     y += r.height() + text_spacing;
   }
 
   std::string sol_str;
-  if (m_solver.is_finished() && m_solver.was_contradiction_found())
+  if (m_inconsistent)
     sol_str = "No solution";
-  else if (m_solver.num_solutions() == 1)
+  else if (progress.num_solutions == 1)
     sol_str = "Found 1 solution";
-  else if (m_solver.num_solutions() > 1)
-    sol_str = "Found " + std::to_string(m_solver.num_solutions())
+  else if (progress.num_solutions > 1)
+    sol_str = "Found " + std::to_string(progress.num_solutions)
       + " solutions";
   if (!sol_str.empty()) {
     r = renderer.draw_text(Point(x, y), m_font, sol_str);
@@ -172,20 +173,43 @@ void AnalysisPanel::setup_buttons()
   m_solve_button = Button(m_font, "Solve");
   m_solve_button.resize(button_width, m_solve_button.boundary().height());
   m_solve_button.register_callback([this]() {
-      if (!m_solver_running && !m_puzzle.is_solved())
-        m_solver_running = true; });
+      if (!m_solver_task.is_started() && !m_puzzle.is_solved())
+        m_solver_task.start(m_puzzle); });
   m_close_button = Button(m_font, "Close");
   m_close_button.resize(button_width, m_close_button.boundary().height());
   m_preview.attach_puzzle(m_puzzle);
 }
 
+/*
+ * Called once the solver task is done. The solver worked on its own
+ * copy of the puzzle, so the first solution is copied back here.
+ */
+void AnalysisPanel::collect_results()
+{
+  Solver& solver = m_solver_task.solver();
+  if (solver.is_finished() && !solver.was_contradiction_found()) {
+    m_done_solving = true;
+    m_line_solvable = solver.is_line_solvable();
+    show_solution();
+  } else if (solver.was_contradiction_found()) {
+    m_inconsistent = true;
+  }
+}
+
+void AnalysisPanel::show_solution()
+{
+  CompressedState state;
+  m_solver_task.puzzle().copy_state(state);
+  m_puzzle.load_state(state);
+}
+
 void AnalysisPanel::calc_size()
 {
   int width = 2 * panel_spacing;
   int height = panel_spacing;
 
   int text_wd, text_ht;
-  m_font.text_size("Status: ready", &text_wd, &text_ht);
+  m_font.text_size("Status: solving (100%)", &text_wd, &text_ht);
   width = std::max(width, text_wd + 2 * panel_spacing);
   height += text_ht + text_spacing;
 
@@ -23,7 +23,7 @@
 
 #include <functional>
 #include "puzzle/puzzle.hpp"
-#include "solver/solver.hpp"
+#include "solver/solver_task.hpp"
 #include "ui/button.hpp"
 #include "ui/puzzle_preview.hpp"
 #include "ui/ui_panel.hpp"
@@ -55,16 +55,19 @@ private:
   void focus_prev();
   void focus_next();
 
+  void collect_results();
+  void show_solution();
+
   Puzzle m_puzzle;
-  Solver m_solver;
+  SolverTask m_solver_task; //solves a copy of m_puzzle in the background
   const Font& m_font;
 
   PuzzlePreview m_preview;
   Button m_solve_button;
   Button m_close_button;
-  bool m_solver_running = false;
   bool m_done_solving = false;
   bool m_inconsistent = false;
+  bool m_line_solvable = false;
   unsigned m_run_time = 0;
   unsigned m_sol_cycle_time = 0;
 };
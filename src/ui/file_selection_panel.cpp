@@ -22,10 +22,12 @@
 
 #include <algorithm>
 #include <fstream>
+#include <system_error>
 #include <experimental/filesystem>
 #include "color/color.hpp"
 #include "input/input_handler.hpp"
 #include "puzzle/puzzle_io.hpp"
+#include "puzzle/puzzle_pack.hpp"
 #include "save/save_manager.hpp"
 #include "utility/utility.hpp"
 #include "video/font.hpp"
@@ -38,7 +40,7 @@ const Color background_color = default_colors::white;
 const Color foreground_color = default_colors::black;
 const Color selection_color = default_colors::blue;
 constexpr int spacing = 4;
-constexpr int max_puzzles_open = 9999;
+constexpr int entries_per_update = 512;
 
 FileSelectionPanel::FileSelectionPanel(SaveManager& save_mgr,
                                        Font& filename_font, Font& info_font,
@@ -87,6 +89,11 @@ std::string FileSelectionPanel::selected_file() const
     return "";
 }
 
+bool FileSelectionPanel::is_loading() const
+{
+  return m_is_listing || next_unloaded_puzzle() >= 0;
+}
+
 void FileSelectionPanel::on_file_select(Callback fn)
 {
   m_file_sel_callback = fn;
@@ -105,11 +112,16 @@ void FileSelectionPanel::on_dir_change(Callback fn)
 void FileSelectionPanel::update(unsigned ticks, InputHandler& input,
                                 const Rect& active_region)
 {
+  if (m_is_listing)
+    continue_file_list();
+
+  visible_entries(active_region, &m_first_visible, &m_last_visible);
+
   if (!m_files.empty()) {
-    //see if we have new puzzle to read
-    if (m_num_puzzles_loaded < static_cast<int>(m_files.size())
-        && m_num_puzzles_loaded < max_puzzles_open)
-      load_puzzle_info();
+    //read information for one visible puzzle per frame
+    int index = next_unloaded_puzzle();
+    if (index >= 0)
+      load_puzzle_info(index);
 
     //check for mouse click to select a file
     Point cursor = input.mouse_position();
@@ -174,24 +186,8 @@ void FileSelectionPanel::draw(Renderer& renderer, const Rect& region) const
 {
   renderer.set_clip_rect(region);
 
-  //figure out which file entries are on screen
-  int min_y = region.y() - m_boundary.y();
-  if (min_y < 0) min_y = 0;
-  int max_y = min_y + region.height();
   int min_index, max_index;
-  if (m_files.empty()) {
-    min_index = max_index = 0;
-  } else {
-    min_index = min_y / entry_height();
-    if (min_index > 0)
-      --min_index;
-    if (min_index > static_cast<int>(m_files.size()))
-      min_index = m_files.size() - 1;
-
-    max_index = max_y / entry_height() + 1;
-    if (max_index > static_cast<int>(m_files.size()))
-      max_index = m_files.size();
-  }
+  visible_entries(region, &min_index, &max_index);
 
   //draw the file entries
   for (int i = min_index; i < max_index; ++i) {
@@ -229,10 +225,7 @@ void FileSelectionPanel::draw(Renderer& renderer, const Rect& region) const
                         y + icon_height / 2 - ht/ 2);
         renderer.draw_text(qmark_loc, m_filename_font, "?");
       } else if (prog) {
-        if (prog->is_complete())
-          draw_progress(renderer, prog->solution(), dest);
-        else
-          draw_progress(renderer, prog->state(), dest);
+        draw_progress(renderer, m_files[i], dest);
       }
     } else {
       renderer.copy_texture(m_icon_texture, src, dest);
@@ -306,30 +299,22 @@ void FileSelectionPanel::draw(Renderer& renderer, const Rect& region) const
 }
 
 void FileSelectionPanel::draw_progress(Renderer& renderer,
-                                       const PuzzleGrid& grid,
+                                       const FileInfo& info,
                                        const Rect& area) const
 {
-  if (!grid.width() || !grid.height())
-    return;
-
-  int pixel_size = area.width() / grid.width();
-  if (area.height() / grid.height() < pixel_size)
-    pixel_size = area.height() / grid.height();
-
-  Point start(area.x() + area.width() / 2 - pixel_size * grid.width() / 2,
-              area.y() + area.height() / 2 - pixel_size * grid.height() / 2);
-
-  for (int y = 0; y != grid.height(); ++y) {
-    for (int x = 0; x != grid.width(); ++x) {
-      if (grid.at(x, y).state == PuzzleCell::State::filled) {
-        Rect pixel(start.x() + x * pixel_size,
-                   start.y() + y * pixel_size,
-                   pixel_size, pixel_size);
-        renderer.set_draw_color(grid.at(x, y).color);
-        renderer.fill_rect(pixel);
-      }
-    }
+  //the progress only changes when it is reloaded, which discards the
+  //old thumbnail, so each one only needs to be built once
+  auto& thumbnail = info.thumbnail;
+  if (!thumbnail) {
+    const PuzzleProgress& prog = *info.puzzle_progress;
+    thumbnail = std::make_shared<PuzzleThumbnail>();
+    if (prog.is_complete())
+      thumbnail->update(renderer, prog.solution(), background_color);
+    else
+      thumbnail->update(renderer, prog.state(), background_color);
   }
+
+  thumbnail->draw(renderer, area);
 }
 
 void FileSelectionPanel::select(int index)
@@ -362,42 +347,106 @@ int FileSelectionPanel::entry_height() const
   return m_icon_texture.height() + 2 * spacing;
 }
 
+void FileSelectionPanel::visible_entries(const Rect& region,
+                                         int* first_index,
+                                         int* last_index) const
+{
+  int min_y = region.y() - m_boundary.y();
+  if (min_y < 0) min_y = 0;
+  int max_y = min_y + region.height();
+  int min_index, max_index;
+  if (m_files.empty()) {
+    min_index = max_index = 0;
+  } else {
+    min_index = min_y / entry_height();
+    if (min_index > 0)
+      --min_index;
+    if (min_index > static_cast<int>(m_files.size()))
+      min_index = m_files.size() - 1;
+
+    max_index = max_y / entry_height() + 1;
+    if (max_index > static_cast<int>(m_files.size()))
+      max_index = m_files.size();
+  }
+
+  if (first_index) *first_index = min_index;
+  if (last_index) *last_index = max_index;
+}
+
+/*
+ * Start listing the current path. Directories are read incrementally
+ * by continue_file_list so that opening one with a huge number of
+ * entries does not stall the interface.
+ */
 void FileSelectionPanel::load_file_list()
 {
   m_files.clear();
   m_selection = 0;
   m_is_selected = false;
-  m_num_puzzles_loaded = 0;
-
-  if (!m_path.empty()) {
-    stdfs::path p(m_path);
-
-    for (const auto& file : stdfs::directory_iterator(p)) {
-      FileInfo info;
-      info.full_path = file.path().string();
-      info.filename = file.path().filename().string();
-      if (stdfs::is_directory(file))
-        info.type = FileInfo::Type::directory;
-      else { //check for puzzle file
-        std::string extension = file.path().extension().string();
-        if (extension == ".non")
-          info.type = FileInfo::Type::puzzle_file;
-        else if (extension == ".g")
-          info.type = FileInfo::Type::puzzle_file;
-        else if (extension == ".mk")
-          info.type = FileInfo::Type::puzzle_file;
-        else if (extension == ".nin")
-          info.type = FileInfo::Type::puzzle_file;
-        else
-          info.type = FileInfo::Type::file;
-      }
-      m_files.push_back(info);
-    }
+  m_is_listing = false;
+  m_dir_iter = stdfs::directory_iterator();
+  m_first_visible = m_last_visible = 0;
+
+  if (!m_path.empty() && is_pack_file(m_path)
+      && !stdfs::is_directory(m_path)) {
+    load_pack_list();
+    sort_files(0);
+  } else if (!m_path.empty()) {
+    m_dir_iter = stdfs::directory_iterator(stdfs::path(m_path));
+    m_is_listing = true;
+    continue_file_list();
   }
 
   resize(entry_height() * 3, entry_height() * m_files.size());
+}
+
+void FileSelectionPanel::continue_file_list()
+{
+  std::size_t first_new = m_files.size();
+
+  std::error_code ec;
+  int count = 0;
+  while (count < entries_per_update
+         && m_dir_iter != stdfs::directory_iterator()) {
+    const auto& file = *m_dir_iter;
+
+    FileInfo info;
+    info.full_path = file.path().string();
+    info.filename = file.path().filename().string();
+    if (stdfs::is_directory(file.status()))
+      info.type = FileInfo::Type::directory;
+    else { //check for puzzle file
+      std::string extension = file.path().extension().string();
+      if (extension == ".non")
+        info.type = FileInfo::Type::puzzle_file;
+      else if (extension == ".g")
+        info.type = FileInfo::Type::puzzle_file;
+      else if (extension == ".mk")
+        info.type = FileInfo::Type::puzzle_file;
+      else if (extension == ".nin")
+        info.type = FileInfo::Type::puzzle_file;
+      else if (extension == ".nbn")
+        info.type = FileInfo::Type::puzzle_file;
+      else if (is_pack_file(info.filename))
+        info.type = FileInfo::Type::directory; //browsed like a directory
+      else
+        info.type = FileInfo::Type::file;
+    }
+    m_files.push_back(std::move(info));
+    ++count;
+
+    m_dir_iter.increment(ec);
+    if (ec) //stop at unreadable entries rather than throwing mid-frame
+      m_dir_iter = stdfs::directory_iterator();
+  }
+
+  if (m_dir_iter == stdfs::directory_iterator())
+    m_is_listing = false;
 
-  sort_files();
+  if (m_files.size() != first_new) {
+    sort_files(first_new);
+    resize(entry_height() * 3, entry_height() * m_files.size());
+  }
 }
 
 bool
@@ -411,35 +460,97 @@ FileSelectionPanel::file_info_less_than(const FileInfo& l, const FileInfo& r)
     return l.type == FileInfo::Type::directory;
 }
 
-void FileSelectionPanel::sort_files()
+/*
+ * Sort the entries from first_new onward and merge them into the
+ * already sorted entries before them, keeping the same file selected.
+ */
+void FileSelectionPanel::sort_files(std::size_t first_new)
+{
+  std::string selected_path;
+  if (m_is_selected)
+    selected_path = m_files[m_selection].full_path;
+
+  auto middle = m_files.begin() + first_new;
+  std::sort(middle, m_files.end(), file_info_less_than);
+  std::inplace_merge(m_files.begin(), middle, m_files.end(),
+                     file_info_less_than);
+
+  if (m_is_selected) {
+    for (std::size_t i = 0; i < m_files.size(); ++i) {
+      if (m_files[i].full_path == selected_path) {
+        m_selection = i;
+        break;
+      }
+    }
+  }
+}
+
+/*
+ * List the contents of a puzzle pack. The summaries come straight from
+ * the pack's table of contents, so no puzzle needs to be skimmed.
+ */
+void FileSelectionPanel::load_pack_list()
 {
-  std::sort(m_files.begin(), m_files.end(), file_info_less_than);
+  PuzzlePack pack;
+  try {
+    pack.open(m_path);
+  } catch (const std::exception&) {
+    return; //show an empty listing for unreadable packs
+  }
+
+  m_files.reserve(pack.size());
+  for (const auto& entry : pack) {
+    FileInfo info;
+    info.filename = entry.name;
+    info.full_path = (stdfs::path(m_path) / entry.name).string();
+    info.type = FileInfo::Type::puzzle_file;
+    info.puzzle_info = std::make_shared<PuzzleSummary>(entry.summary);
+    m_files.push_back(std::move(info));
+  }
 }
 
-void FileSelectionPanel::load_puzzle_info()
+//find a puzzle in the visible range whose information is not loaded
+int FileSelectionPanel::next_unloaded_puzzle() const
 {
-  int index = m_num_puzzles_loaded;
+  int last = std::min(m_last_visible, static_cast<int>(m_files.size()));
+  for (int i = m_first_visible; i < last; ++i) {
+    if (m_files[i].type == FileInfo::Type::puzzle_file
+        && !m_files[i].puzzle_progress)
+      return i;
+  }
+  return -1;
+}
 
-  auto summary = std::make_shared<PuzzleSummary>();
+void FileSelectionPanel::load_puzzle_info(int index)
+{
   auto progress = std::make_shared<PuzzleProgress>();
+  auto summary = m_files[index].puzzle_info;
+
+  //pack entries already have their summary
+  if (!summary) {
+    summary = std::make_shared<PuzzleSummary>();
 
-  std::string file_path = m_files[index].full_path;
-  std::ifstream sfile(file_path);
-  if (sfile.is_open()) {
+    std::string file_path = m_files[index].full_path;
     std::string extension = stdfs::path(file_path).extension().string();
-    if (extension == ".non")
-      skim_puzzle(sfile, *summary, PuzzleFormat::non);
-    else if (extension == ".g")
-      skim_puzzle(sfile, *summary, PuzzleFormat::g);
-    else if (extension == ".mk")
-      skim_puzzle(sfile, *summary, PuzzleFormat::mk);
-    else if (extension == ".nin")
-      skim_puzzle(sfile, *summary, PuzzleFormat::nin);
-    else
-      skim_puzzle(sfile, *summary);
+    std::ifstream sfile(file_path, extension == ".nbn"
+                        ? std::ios::in | std::ios::binary : std::ios::in);
+    if (sfile.is_open()) {
+      if (extension == ".non")
+        skim_puzzle(sfile, *summary, PuzzleFormat::non);
+      else if (extension == ".g")
+        skim_puzzle(sfile, *summary, PuzzleFormat::g);
+      else if (extension == ".mk")
+        skim_puzzle(sfile, *summary, PuzzleFormat::mk);
+      else if (extension == ".nin")
+        skim_puzzle(sfile, *summary, PuzzleFormat::nin);
+      else if (extension == ".nbn")
+        skim_puzzle(sfile, *summary, PuzzleFormat::nbn);
+      else
+        skim_puzzle(sfile, *summary);
+    }
+    sfile.close();
+    m_files[index].puzzle_info = summary;
   }
-  sfile.close();
-  m_files[index].puzzle_info = summary;
 
   std::string collection = summary->collection;
   std::string id = summary->id;
@@ -456,6 +567,5 @@ void FileSelectionPanel::load_puzzle_info()
                            m_files[index].full_path,
                            collection, id);
   m_files[index].puzzle_progress = progress;
-
-  ++m_num_puzzles_loaded;
+  m_files[index].thumbnail.reset();
 }
@@ -25,8 +25,10 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <experimental/filesystem>
 #include "puzzle/puzzle_progress.hpp"
 #include "puzzle/puzzle_summary.hpp"
+#include "ui/puzzle_thumbnail.hpp"
 #include "ui/ui_panel.hpp"
 
 class Font;
@@ -50,6 +52,10 @@ public:
   std::string path() const { return m_path; }
   void open_selection();
 
+  //true while the directory listing or visible puzzle information is
+  //still being read
+  bool is_loading() const;
+
   /*
    * Register callback functions. A callback function receives a
    * string with the name of the file or directory that was selected
@@ -67,17 +73,22 @@ public:
   void draw(Renderer& renderer, const Rect& region) const override;
 
 private:
-  void draw_progress(Renderer& renderer, const PuzzleGrid& grid,
-                     const Rect& area) const;
   void select(int index);
   void make_selection_visible(const Rect& visible_region);
   int entry_height() const;
+  void visible_entries(const Rect& region,
+                       int* first_index, int* last_index) const;
   void load_file_list();
-  void sort_files();
-  void load_puzzle_info();
+  void continue_file_list();
+  void load_pack_list();
+  void sort_files(std::size_t first_new);
+  void load_puzzle_info(int index);
+  int next_unloaded_puzzle() const;
 
   struct FileInfo;
   static bool file_info_less_than(const FileInfo& l, const FileInfo& r);
+  void draw_progress(Renderer& renderer, const FileInfo& info,
+                     const Rect& area) const;
 
   struct FileInfo {
     std::string filename;
@@ -85,6 +96,9 @@ private:
     enum class Type { directory, file, puzzle_file } type = Type::file;
     std::shared_ptr<PuzzleSummary> puzzle_info;
     std::shared_ptr<PuzzleProgress> puzzle_progress;
+
+    //image of puzzle_progress, built the first time it is drawn
+    mutable std::shared_ptr<PuzzleThumbnail> thumbnail;
   };
 
   SaveManager& m_save_mgr;
@@ -95,7 +109,14 @@ private:
   std::vector<FileInfo> m_files;
   int m_selection = 0;
   bool m_is_selected = false;
-  int m_num_puzzles_loaded = 0;
+
+  //directory entries are read a batch at a time in update
+  std::experimental::filesystem::directory_iterator m_dir_iter;
+  bool m_is_listing = false;
+
+  //range of entries shown during the last update
+  int m_first_visible = 0;
+  int m_last_visible = 0;
 
   Callback m_file_open_callback;
   Callback m_file_sel_callback;
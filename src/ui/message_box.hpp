@@ -39,6 +39,10 @@ public:
   void position_controls() override;
   void recalculate_size();
 
+  //replace the message; call recalculate_size afterward if the new
+  //text may need a different number of lines
+  void set_text(const std::string& text) { m_text = text; }
+
   using Dialog::draw;
   void draw(Renderer& renderer, const Rect& region) const override;
 
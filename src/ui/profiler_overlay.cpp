@@ -0,0 +1,132 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "ui/profiler_overlay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "color/color.hpp"
+#include "utility/profiler.hpp"
+#include "video/font.hpp"
+#include "video/rect.hpp"
+#include "video/renderer.hpp"
+
+const Color foreground_color(255, 255, 255);
+const Color background_color(32, 32, 32);
+const Color fast_frame_color(0, 192, 0);
+const Color slow_frame_color(224, 0, 0);
+const Color target_line_color(255, 255, 0);
+
+constexpr int padding = 4;
+constexpr int graph_height = 100;
+constexpr unsigned graph_max_time = 33333; //microseconds
+constexpr unsigned target_frame_time = 16667;
+
+std::string format_ms(unsigned time)
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.2f ms", time / 1000.0);
+  return buf;
+}
+
+void draw_profiler_overlay(Renderer& renderer,
+                           Point position,
+                           Font& font)
+{
+  const Profiler& prof = Profiler::instance();
+  std::size_t num_frames = prof.num_frames();
+
+  //gather averages over the recorded frames
+  unsigned long total_time = 0;
+  unsigned max_time = 0;
+  std::vector<unsigned long> section_totals(Profiler::num_sections, 0);
+  std::vector<unsigned long> section_calls(Profiler::num_sections, 0);
+  for (std::size_t f = 0; f < num_frames; ++f) {
+    const auto& frame = prof.frame(f);
+    total_time += frame.time;
+    max_time = std::max(max_time, frame.time);
+    for (int i = 0; i < Profiler::num_sections; ++i) {
+      section_totals[i] += frame.section_time[i];
+      section_calls[i] += frame.calls[i];
+    }
+  }
+  unsigned long divisor = std::max<std::size_t>(num_frames, 1);
+
+  std::vector<std::string> lines;
+  lines.push_back("frame  avg " + format_ms(total_time / divisor)
+                  + "  max " + format_ms(max_time));
+  for (int i = 0; i < Profiler::num_sections; ++i) {
+    auto section = static_cast<Profiler::Section>(i);
+    lines.push_back(std::string(Profiler::section_name(section))
+                    + "  " + format_ms(section_totals[i] / divisor)
+                    + "  " + std::to_string(section_calls[i] / divisor)
+                    + " calls");
+  }
+
+  int line_height = 0;
+  int text_width = 0;
+  for (const auto& line : lines) {
+    int wd, ht;
+    font.text_size(line, &wd, &ht);
+    text_width = std::max(text_width, wd);
+    line_height = std::max(line_height, ht);
+  }
+
+  int graph_width = static_cast<int>(Profiler::max_frames);
+  Rect bound(position.x(), position.y(),
+             std::max(graph_width, text_width) + 2 * padding,
+             graph_height + 3 * padding
+             + line_height * static_cast<int>(lines.size()));
+  renderer.set_draw_color(background_color);
+  renderer.fill_rect(bound);
+
+  //one vertical bar per frame, newest on the right
+  int graph_left = bound.x() + padding
+    + graph_width - static_cast<int>(num_frames);
+  int graph_bottom = bound.y() + padding + graph_height;
+  std::vector<Point> fast_bars, slow_bars;
+  for (std::size_t f = 0; f < num_frames; ++f) {
+    unsigned time = std::min(prof.frame(f).time, graph_max_time);
+    int height = static_cast<int>(time * graph_height / graph_max_time);
+    int x = graph_left + static_cast<int>(f);
+    auto& bars = time > target_frame_time ? slow_bars : fast_bars;
+    bars.push_back(Point(x, graph_bottom));
+    bars.push_back(Point(x, graph_bottom - height));
+  }
+  renderer.set_draw_color(fast_frame_color);
+  renderer.draw_lines(fast_bars);
+  renderer.set_draw_color(slow_frame_color);
+  renderer.draw_lines(slow_bars);
+
+  int target_y = graph_bottom
+    - static_cast<int>(target_frame_time * graph_height / graph_max_time);
+  renderer.set_draw_color(target_line_color);
+  renderer.draw_line(Point(bound.x() + padding, target_y),
+                     Point(bound.x() + padding + graph_width - 1, target_y));
+
+  renderer.set_draw_color(foreground_color);
+  int y = graph_bottom + padding;
+  for (const auto& line : lines) {
+    renderer.draw_text(Point(bound.x() + padding, y), font, line);
+    y += line_height;
+  }
+}
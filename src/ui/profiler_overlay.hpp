@@ -0,0 +1,38 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_PROFILER_OVERLAY_HPP
+#define NONNY_PROFILER_OVERLAY_HPP
+
+#include "video/point.hpp"
+
+class Font;
+class Renderer;
+
+/*
+ * Draw a graph of recent frame times along with the average time
+ * spent in each profiler section, with the top-left corner at
+ * position.
+ */
+void draw_profiler_overlay(Renderer& renderer,
+                           Point position,
+                           Font& font);
+
+#endif
@@ -20,13 +20,15 @@
 
 #include "ui/puzzle_panel.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <queue>
+#include <cstdint>
+#include <iterator>
 #include <string>
 #include "color/color.hpp"
 #include "input/input_handler.hpp"
 #include "puzzle/puzzle.hpp"
-#include "solver/line_solver.hpp"
+#include "utility/profiler.hpp"
 #include "utility/utility.hpp"
 #include "video/font.hpp"
 #include "video/renderer.hpp"
@@ -40,8 +42,21 @@ const Color lightly_shaded_cell_color(240, 240, 255);
 constexpr int cell_animation_duration = 100;
 constexpr int time_for_mouse_unlock = 96;
 constexpr int max_undo_size = 64;
+constexpr int undo_checkpoint_interval = 16;
+constexpr std::size_t max_bulk_animations = 1024;
 
-const std::vector<int> zoom_levels = { 6, 8, 12, 16, 20, 24, 27, 32, 48,
+const Color lod_crossed_cell_color(208, 208, 224);
+
+//below this cell size the puzzle is drawn as a scaled image, with no
+//grid lines or clues
+constexpr int lod_cell_size = 6;
+//at the smallest zoom level the puzzle is scaled to fit the viewport,
+//but never more than this many pixels per cell
+constexpr double lod_max_fit_pitch = 2.0;
+constexpr double lod_min_pitch = 1.0 / 64;
+
+const std::vector<int> zoom_levels = { 1, 2, 3, 4,
+                                       6, 8, 12, 16, 20, 24, 27, 32, 48,
                                        64, 96,
                                        128, 150};
 constexpr int zoom_speed = 500; //pixels per second
@@ -58,9 +73,25 @@ PuzzlePanel::PuzzlePanel(Font& clue_font, const Texture& cell_texture,
 void PuzzlePanel::attach_puzzle(Puzzle& puzzle)
 {
   m_puzzle = &puzzle;
+  int old_size = m_cur_puzzle_size;
   m_cur_puzzle_size = puzzle.width() * puzzle.height();
-  m_cell_time.resize(m_cur_puzzle_size, 0);
-  m_prev_cell_state.resize(m_cur_puzzle_size, PuzzleCell::State::blank);
+
+  //fade in the marked cells, unless there are too many to be worth it;
+  //blank cells would not change, so they need no animation
+  std::vector<CellAnimation> fades;
+  for (int index = old_size; index < m_cur_puzzle_size; ++index) {
+    const PuzzleCell& cell = (*m_puzzle)[index % puzzle.width()]
+      [index / puzzle.width()];
+    if (cell.state != PuzzleCell::State::blank) {
+      if (fades.size() == max_bulk_animations) {
+        fades.clear();
+        break;
+      }
+      fades.push_back({index, 0, PuzzleCell::State::blank});
+    }
+  }
+  m_animations.insert(m_animations.end(), fades.begin(), fades.end());
+  m_layer_revision = 0;
   calc_grid_pos();
 }
 
@@ -94,6 +125,8 @@ void PuzzlePanel::set_edit_mode(bool edit_mode)
   m_edit_mode = edit_mode;
   m_state_history.clear();
   m_cur_state = m_state_history.begin();
+  m_pending_changes.clear();
+  m_steps_since_checkpoint = 0;
   m_has_state_changed = true;
 }
 
@@ -138,16 +171,35 @@ void PuzzlePanel::update(unsigned ticks, InputHandler& input,
     }
 
     update_cells(ticks);
+    update_hints();
 
     if (m_target_cell_size != m_cell_size)
       update_zoom(ticks);
 
+    if (active_region.width() != m_viewport.width()
+        || active_region.height() != m_viewport.height()) {
+      m_viewport = active_region;
+      if (m_cell_size < lod_cell_size)
+        calc_grid_pos();
+    }
+
     if (!m_mouse_dragging && !m_kb_dragging) {
       m_puzzle->update(m_edit_mode);
+      if (m_edit_mode) {
+        if (m_clue_layout_revision != m_puzzle->revision())
+          update_clue_layout();
+        else if (!m_clue_dirty_rows.empty() || !m_clue_dirty_cols.empty())
+          update_clue_lines();
+      }
       if (m_has_state_changed) {
         m_need_save = !m_state_history.empty();
         save_undo_state();
+
+        //a search still in progress is restarted on the new state
+        bool searching = m_hint_task.is_busy();
         clear_hints();
+        if (searching)
+          m_hint_task.start(*m_puzzle);
       }
     }
 
@@ -162,12 +214,11 @@ void PuzzlePanel::draw(Renderer& renderer, const Rect& region) const
 {
   if (m_puzzle) {
     renderer.set_clip_rect(region);
-    draw_cells(renderer);
-    draw_grid_lines(renderer);
+    draw_cell_layer(renderer, region);
     draw_selection(renderer);
     draw_errors(renderer);
     draw_hints(renderer);
-    draw_clues(renderer);
+    draw_clues(renderer, region);
 
     renderer.set_clip_rect();
   }
@@ -176,26 +227,48 @@ void PuzzlePanel::draw(Renderer& renderer, const Rect& region) const
 void PuzzlePanel::calc_grid_pos()
 {
   if (m_puzzle) {
-    m_clue_font.resize(m_cell_size * 3 / 5);
+    update_clue_font();
+    update_clue_layout();
+
     m_grid_pos.x() = m_boundary.x();
     m_grid_pos.y() = m_boundary.y();
     m_clue_pos.x() = m_boundary.x();
     m_clue_pos.y() = m_boundary.y();
 
-    for (int i = 0; i < m_puzzle->width(); ++i) {
-      int bottom = m_boundary.y() + col_clue_height(i);
-      if (bottom > m_grid_pos.y())
-        m_grid_pos.y() = bottom;
-    }
+    int width = m_puzzle->width();
+    int height = m_puzzle->height();
+    if (m_cell_size < lod_cell_size) {
+      //clues are not shown; the pitch grows geometrically from one
+      //that fits the puzzle to the viewport at the smallest zoom level
+      //up to the normal pitch at lod_cell_size
+      double fit = lod_max_fit_pitch;
+      if (width > 0 && height > 0
+          && m_viewport.width() > 2 && m_viewport.height() > 2)
+        fit = std::min((m_viewport.width() - 2) / static_cast<double>(width),
+                       (m_viewport.height() - 2)
+                       / static_cast<double>(height));
+      double low = std::max(std::min(fit, lod_max_fit_pitch), lod_min_pitch);
+      double high = lod_cell_size + 1;
+      double t = (m_cell_size - 1) / static_cast<double>(lod_cell_size - 1);
+      m_pitch = low * std::pow(high / low, t);
+    } else {
+      m_pitch = m_cell_size + 1;
+
+      for (int i = 0; i < width; ++i) {
+        int bottom = m_boundary.y() + col_clue_height(i);
+        if (bottom > m_grid_pos.y())
+          m_grid_pos.y() = bottom;
+      }
 
-    for (int j = 0; j < m_puzzle->height(); ++j) {
-      int side = m_boundary.x() + row_clue_width(j);
-      if (side > m_grid_pos.x())
-        m_grid_pos.x() = side;
+      for (int j = 0; j < height; ++j) {
+        int side = m_boundary.x() + row_clue_width(j);
+        if (side > m_grid_pos.x())
+          m_grid_pos.x() = side;
+      }
     }
 
-    int grid_width = m_puzzle->width() * (m_cell_size + 1) + 1;
-    int grid_height = m_puzzle->height() * (m_cell_size + 1) + 1;
+    int grid_width = cell_offset(width) + 1;
+    int grid_height = cell_offset(height) + 1;
     m_boundary.width()
       = (m_grid_pos.x() - m_boundary.x()) + grid_width;
     m_boundary.height()
@@ -213,138 +286,399 @@ void PuzzlePanel::calc_grid_pos()
   }
 }
 
-int PuzzlePanel::row_clue_width(int row) const
+void PuzzlePanel::layout_clue_line(const Puzzle::ClueSequence& clues,
+                                   bool horizontal,
+                                   ClueLayout::Line& line) const
 {
-  int width = 0;
-  for (auto clue : m_puzzle->row_clues(row)) {
-    int text_wd, text_ht;
-    m_clue_font.text_size(std::to_string(clue.value), &text_wd, &text_ht);
-    width += text_wd + clue_spacing();
+  line.entries.clear();
+  int offset = 0;
+  for (const auto& clue : clues) {
+    ClueLayout::Entry entry;
+    entry.text = std::to_string(clue.value);
+    m_clue_font.text_size(entry.text, &entry.width, &entry.height);
+    entry.offset = offset;
+    offset += (horizontal ? entry.width : entry.height) + clue_spacing();
+    line.entries.push_back(std::move(entry));
   }
-  return width;
+  line.size = offset;
 }
 
-int PuzzlePanel::col_clue_height(int col) const
+void PuzzlePanel::update_clue_layout()
 {
-  int height = 0;
-  for (auto clue : m_puzzle->col_clues(col)) {
-    int text_wd, text_ht;
-    m_clue_font.text_size(std::to_string(clue.value), &text_wd, &text_ht);
-    height += text_ht + clue_spacing();
-  }
-  return height;
+  const auto& row_clues = m_puzzle->row_clues();
+  const auto& col_clues = m_puzzle->col_clues();
+  m_clue_layout.rows.resize(row_clues.size());
+  m_clue_layout.cols.resize(col_clues.size());
+  for (std::size_t j = 0; j < row_clues.size(); ++j)
+    layout_clue_line(row_clues[j], true, m_clue_layout.rows[j]);
+  for (std::size_t i = 0; i < col_clues.size(); ++i)
+    layout_clue_line(col_clues[i], false, m_clue_layout.cols[i]);
+
+  m_clue_layout_revision = m_puzzle->revision();
+  m_clue_dirty_rows.clear();
+  m_clue_dirty_cols.clear();
 }
 
-void PuzzlePanel::draw_grid_lines(Renderer& renderer) const
+void PuzzlePanel::update_clue_lines()
 {
-  renderer.set_draw_color(cell_border_color);
-  int width = m_puzzle->width();
-  int height = m_puzzle->height();
-  for (int x = 0; x <= width; ++x) {
-    Point start(m_grid_pos.x() + x * (m_cell_size + 1), m_grid_pos.y());
-    Point end(start.x(), m_grid_pos.y() + height * (m_cell_size + 1));
+  auto update_lines = [this](std::vector<int>& dirty,
+                             const Puzzle::ClueContainer& clues,
+                             bool horizontal,
+                             std::vector<ClueLayout::Line>& lines) {
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    for (int index : dirty)
+      layout_clue_line(clues[index], horizontal, lines[index]);
+    dirty.clear();
+  };
+
+  update_lines(m_clue_dirty_rows, m_puzzle->row_clues(), true,
+               m_clue_layout.rows);
+  update_lines(m_clue_dirty_cols, m_puzzle->col_clues(), false,
+               m_clue_layout.cols);
+}
+
+void PuzzlePanel::visible_cells(const Rect& region,
+                                int* first_col, int* last_col,
+                                int* first_row, int* last_row) const
+{
+  //index of the cell containing a coordinate, rounding toward -inf
+  auto floor_index = [this](int offset) {
+    return static_cast<int>(std::floor(offset / m_pitch));
+  };
+
+  *first_col = std::max(floor_index(region.x() - m_grid_pos.x()), 0);
+  *last_col = std::min(floor_index(region.x() + region.width()
+                                   - m_grid_pos.x()) + 1,
+                       m_puzzle->width());
+  *first_row = std::max(floor_index(region.y() - m_grid_pos.y()), 0);
+  *last_row = std::min(floor_index(region.y() + region.height()
+                                   - m_grid_pos.y()) + 1,
+                       m_puzzle->height());
+
+  if (*last_col < *first_col)
+    *last_col = *first_col;
+  if (*last_row < *first_row)
+    *last_row = *first_row;
+}
+
+void PuzzlePanel::draw_clues(Renderer& renderer, const Rect& region) const
+{
+  ScopedTimer timer(Profiler::Section::puzzle_clues);
+
+  constexpr double finished_fade = 0.33;
+
+  if (m_cell_size < lod_cell_size)
+    return;
+
+  int first_col, last_col, first_row, last_row;
+  visible_cells(region, &first_col, &last_col, &first_row, &last_row);
 
-    if (x % 5 == 0)
-      renderer.draw_thick_line(start, end.y() - start.y(), 3, true);
+  auto set_clue_color = [&renderer](const PuzzleClue& clue) {
+    if (clue.state == PuzzleClue::State::finished)
+      renderer.set_draw_color(clue.color.fade(finished_fade));
     else
-      renderer.draw_line(start, end);
+      renderer.set_draw_color(clue.color);
+  };
+
+  //column clues sit above the grid and row clues to its left, so
+  //they can be visible even when no cells are
+  const ClueLayout& layout = m_clue_layout;
+  if (region.y() < m_grid_pos.y()
+      && static_cast<int>(layout.cols.size()) == m_puzzle->width()) {
+    for (int i = first_col; i < last_col; ++i) {
+      const auto& clues = m_puzzle->col_clues(i);
+      const auto& line = layout.cols[i];
+      if (line.entries.size() != clues.size())
+        continue;
+
+      int x = m_grid_pos.x() + cell_offset(i);
+      int y = m_grid_pos.y() - line.size;
+      for (std::size_t k = 0; k < clues.size(); ++k) {
+        const auto& entry = line.entries[k];
+        if (y + entry.offset + entry.height < region.y())
+          continue;
+
+        set_clue_color(clues[k]);
+        Point pos(x + cell_offset(1) / 2 - entry.width / 2,
+                  y + entry.offset);
+        renderer.draw_text(pos, m_clue_font, entry.text);
+      }
+    }
   }
-  for (int y = 0; y <= height; ++y) {
-    Point start(m_grid_pos.x(), m_grid_pos.y() + y * (m_cell_size + 1));
-    Point end(m_grid_pos.x() + width * (m_cell_size + 1), start.y());
 
-    if (y % 5 == 0)
-      renderer.draw_thick_line(start, end.x() - start.x(), 3, false);
-    else
-      renderer.draw_line(start, end);
+  if (region.x() < m_grid_pos.x()
+      && static_cast<int>(layout.rows.size()) == m_puzzle->height()) {
+    for (int j = first_row; j < last_row; ++j) {
+      const auto& clues = m_puzzle->row_clues(j);
+      const auto& line = layout.rows[j];
+      if (line.entries.size() != clues.size())
+        continue;
+
+      int x = m_grid_pos.x() - line.size;
+      int y = m_grid_pos.y() + cell_offset(j);
+      for (std::size_t k = 0; k < clues.size(); ++k) {
+        const auto& entry = line.entries[k];
+        if (x + entry.offset + entry.width < region.x())
+          continue;
+
+        set_clue_color(clues[k]);
+        Point pos(x + entry.offset,
+                  y + cell_offset(1) / 2 - entry.height / 2);
+        renderer.draw_text(pos, m_clue_font, entry.text);
+      }
+    }
   }
 }
 
-void PuzzlePanel::draw_clues(Renderer& renderer) const
+void PuzzlePanel::draw_cell_layer(Renderer& renderer,
+                                  const Rect& region) const
 {
-  constexpr double finished_fade = 0.33;
+  ScopedTimer timer(Profiler::Section::puzzle_cells);
+
+  int first_col, last_col, first_row, last_row;
+  visible_cells(region, &first_col, &last_col, &first_row, &last_row);
+  if (first_col == last_col || first_row == last_row)
+    return;
+
+  //textures drawn before a device reset must be made again
+  if (m_target_generation != renderer.target_generation()) {
+    m_layer.reset();
+    m_lod_image.reset();
+    m_target_generation = renderer.target_generation();
+  }
 
-  int x, y;
-  for (int i = 0; i < m_puzzle->width(); ++i) {
-    x = m_grid_pos.x() + i * (m_cell_size + 1);
-    y = m_grid_pos.y() - col_clue_height(i);
-    for (auto clue : m_puzzle->col_clues(i)) {
-      Color color;
-      if (clue.state == PuzzleClue::State::finished) {
-        color = clue.color.fade(finished_fade);
-      } else {
-        color = clue.color;
+  if (m_cell_size < lod_cell_size) {
+    draw_lod_image(renderer, first_col, last_col, first_row, last_row);
+    return;
+  }
+
+  //screen area covered by the visible cells, including the part of
+  //the thick border lines that extends outside the grid
+  Rect area(m_grid_pos.x() + cell_offset(first_col) - 1,
+            m_grid_pos.y() + cell_offset(first_row) - 1,
+            cell_offset(last_col) - cell_offset(first_col) + 3,
+            cell_offset(last_row) - cell_offset(first_row) + 3);
+
+  bool redraw_all = m_layer_area.x() != area.x()
+    || m_layer_area.y() != area.y()
+    || m_layer_area.width() != area.width()
+    || m_layer_area.height() != area.height()
+    || m_layer_grid_pos.x() != m_grid_pos.x()
+    || m_layer_grid_pos.y() != m_grid_pos.y()
+    || m_layer_cell_size != m_cell_size
+    || m_layer_revision != m_puzzle->revision();
+
+  if (!m_layer || m_layer->width() != area.width()
+      || m_layer->height() != area.height()) {
+    m_layer = renderer.new_target_texture(area.width(), area.height());
+    redraw_all = true;
+  }
+
+  CellBatch batch;
+  if (!m_layer) {
+    //no render targets, draw everything directly
+    for (int y = first_row; y < last_row; ++y) {
+      for (int x = first_col; x < last_col; ++x) {
+        const PuzzleCell& cell = (*m_puzzle)[x][y];
+        add_cell(batch, m_grid_pos, x, y, cell.state, cell.state,
+                 cell.color, cell_animation_duration);
       }
-      renderer.set_draw_color(color);
-      //Color bg_color = default_colors::white;
-      //if (m_color != default_colors::black && color == m_color)
-      //  bg_color = Color(192, 192, 192);
-      std::string value = std::to_string(clue.value);
-      int wd, ht;
-      m_clue_font.text_size(value, &wd, &ht);
-      Point pos(x + (m_cell_size + 1) / 2 - wd / 2, y);
-      renderer.draw_text(pos, m_clue_font, value);
-      //renderer.draw_text_with_bg(pos, m_clue_font, value, bg_color);
-      y += ht + clue_spacing();
     }
+    add_grid_lines(batch, m_grid_pos,
+                   first_col, last_col, first_row, last_row);
+    draw_cell_batch(renderer, batch);
+    draw_cell_animations(renderer, first_col, last_col, first_row, last_row);
+    m_dirty_cells.clear();
+    return;
   }
 
-  for (int j = 0; j < m_puzzle->height(); ++j) {
-    x = m_grid_pos.x() - row_clue_width(j);
-    y = m_grid_pos.y() + j * (m_cell_size + 1);
-    for (auto clue : m_puzzle->row_clues(j)) {
-      Color color;
-      if (clue.state == PuzzleClue::State::finished) {
-        color = clue.color.fade(finished_fade);
-      } else {
-        color = clue.color;
+  if (redraw_all || !m_dirty_cells.empty()) {
+    Point origin(m_grid_pos.x() - area.x(), m_grid_pos.y() - area.y());
+    if (redraw_all) {
+      for (int y = first_row; y < last_row; ++y) {
+        for (int x = first_col; x < last_col; ++x) {
+          const PuzzleCell& cell = (*m_puzzle)[x][y];
+          add_cell(batch, origin, x, y, cell.state, cell.state,
+                   cell.color, cell_animation_duration);
+        }
+      }
+      add_grid_lines(batch, origin,
+                     first_col, last_col, first_row, last_row);
+    } else {
+      for (int index : m_dirty_cells) {
+        int x = index % m_puzzle->width();
+        int y = index / m_puzzle->width();
+        if (x < first_col || x >= last_col || y < first_row || y >= last_row)
+          continue;
+
+        const PuzzleCell& cell = (*m_puzzle)[x][y];
+        add_cell(batch, origin, x, y, cell.state, cell.state,
+                 cell.color, cell_animation_duration);
+        add_grid_lines(batch, origin, x, x + 1, y, y + 1);
       }
-      renderer.set_draw_color(color);
-      //Color bg_color = default_colors::white;
-      //if (m_color != default_colors::black && color == m_color)
-      //  bg_color = Color(192, 192, 192);
-      std::string value = std::to_string(clue.value);
-      int wd, ht;
-      m_clue_font.text_size(value, &wd, &ht);
-      Point pos(x, y + (m_cell_size + 1) / 2 - ht / 2);
-      renderer.draw_text(pos, m_clue_font, value);
-      //renderer.draw_text_with_bg(pos, m_clue_font, value, bg_color);
-      x += wd + clue_spacing();
     }
+
+    renderer.set_target(*m_layer, redraw_all);
+    renderer.set_clip_rect();
+    draw_cell_batch(renderer, batch);
+    renderer.set_target();
+    renderer.set_clip_rect(region);
+
+    m_layer_area = area;
+    m_layer_grid_pos = m_grid_pos;
+    m_layer_cell_size = m_cell_size;
+    m_layer_revision = m_puzzle->revision();
+    m_dirty_cells.clear();
+  }
+
+  renderer.copy_texture(*m_layer, Rect(), area);
+
+  //animations are drawn over the cached layer
+  draw_cell_animations(renderer, first_col, last_col, first_row, last_row);
+}
+
+void PuzzlePanel::draw_cell_animations(Renderer& renderer,
+                                       int first_col, int last_col,
+                                       int first_row, int last_row) const
+{
+  CellBatch batch;
+  for (const auto& anim : m_animations) {
+    if (anim.index >= m_cur_puzzle_size
+        || anim.time >= cell_animation_duration)
+      continue;
+
+    int x = anim.index % m_puzzle->width();
+    int y = anim.index / m_puzzle->width();
+    if (x < first_col || x >= last_col || y < first_row || y >= last_row)
+      continue;
+
+    const PuzzleCell& cell = (*m_puzzle)[x][y];
+    add_cell(batch, m_grid_pos, x, y, cell.state, anim.prev_state,
+             cell.color, anim.time);
+    add_grid_lines(batch, m_grid_pos, x, x + 1, y, y + 1);
   }
+  draw_cell_batch(renderer, batch);
 }
 
-void PuzzlePanel::draw_cells(Renderer& renderer) const
+void PuzzlePanel::draw_lod_image(Renderer& renderer,
+                                 int first_col, int last_col,
+                                 int first_row, int last_row) const
 {
-  int index = 0;
-  for (int y = 0; y < m_puzzle->height(); ++y) {
-    for (int x = 0; x < m_puzzle->width(); ++x, ++index) {
-      draw_cell(renderer, x, y, (*m_puzzle)[x][y].state,
-                m_prev_cell_state[index], (*m_puzzle)[x][y].color,
-                m_cell_time[index]);
+  int width = m_puzzle->width();
+  int height = m_puzzle->height();
+
+  auto cell_color = [](const PuzzleCell& cell) {
+    if (cell.state == PuzzleCell::State::filled)
+      return cell.color;
+    else if (cell.state == PuzzleCell::State::crossed_out)
+      return lod_crossed_cell_color;
+    return blank_cell_color;
+  };
+  auto pixel = [&cell_color](const PuzzleCell& cell) {
+    Color color = cell_color(cell);
+    return static_cast<std::uint32_t>(color.red()) << 24
+      | static_cast<std::uint32_t>(color.green()) << 16
+      | static_cast<std::uint32_t>(color.blue()) << 8 | 0xff;
+  };
+
+  bool redraw_all = m_lod_revision != m_puzzle->revision();
+  if (!m_lod_image || m_lod_image->width() != width
+      || m_lod_image->height() != height) {
+    m_lod_image = renderer.new_streaming_texture(width, height);
+    redraw_all = true;
+  }
+
+  Rect border(m_grid_pos.x(), m_grid_pos.y(),
+              cell_offset(width) + 2, cell_offset(height) + 2);
+
+  if (!m_lod_image) {
+    //no streaming textures, fill the visible cells that are not blank
+    CellBatch batch;
+    for (int y = first_row; y < last_row; ++y) {
+      for (int x = first_col; x < last_col; ++x) {
+        const PuzzleCell& cell = (*m_puzzle)[x][y];
+        if (cell.state != PuzzleCell::State::blank)
+          batch.fills[cell_color(cell)].push_back(cell_rect(m_grid_pos,
+                                                            x, y));
+      }
+    }
+    renderer.set_draw_color(blank_cell_color);
+    renderer.fill_rect(Rect(border.x() + 1, border.y() + 1,
+                            border.width() - 2, border.height() - 2));
+    draw_cell_batch(renderer, batch);
+    m_lod_dirty_cells.clear();
+  } else {
+    std::vector<std::uint32_t> pixels;
+    if (redraw_all) {
+      pixels.reserve(width * height);
+      for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+          pixels.push_back(pixel((*m_puzzle)[x][y]));
+      renderer.update_texture(*m_lod_image, Rect(0, 0, width, height),
+                              pixels.data());
+    } else {
+      //upload the changed cells of each row as one span
+      std::sort(m_lod_dirty_cells.begin(), m_lod_dirty_cells.end());
+      auto it = m_lod_dirty_cells.begin();
+      while (it != m_lod_dirty_cells.end()) {
+        int y = *it / width;
+        auto row_end = std::lower_bound(it, m_lod_dirty_cells.end(),
+                                        (y + 1) * width);
+        int first = *it % width;
+        int last = *std::prev(row_end) % width;
+
+        pixels.clear();
+        for (int x = first; x <= last; ++x)
+          pixels.push_back(pixel((*m_puzzle)[x][y]));
+        renderer.update_texture(*m_lod_image,
+                                Rect(first, y, last - first + 1, 1),
+                                pixels.data());
+        it = row_end;
+      }
     }
+    m_lod_revision = m_puzzle->revision();
+    m_lod_dirty_cells.clear();
+
+    Rect dest(border.x() + 1, border.y() + 1,
+              std::max(border.width() - 2, 1),
+              std::max(border.height() - 2, 1));
+    renderer.copy_texture(*m_lod_image, Rect(), dest);
   }
+
+  renderer.set_draw_color(cell_border_color);
+  renderer.draw_rect(border);
 }
 
-void PuzzlePanel::draw_cell(Renderer& renderer, int x, int y,
-                            PuzzleCell::State state,
-                            PuzzleCell::State prev_state,
-                            const Color& color,
-                            unsigned animation_time) const
+Rect PuzzlePanel::cell_rect(const Point& origin, int x, int y) const
 {
-  int src_cell_size = m_cell_texture.height() / 3;
-  Rect dest(m_grid_pos.x() + x * (m_cell_size + 1) + 1,
-            m_grid_pos.y() + y * (m_cell_size + 1) + 1,
-            m_cell_size, m_cell_size);
-  Rect src(0, 0, src_cell_size, src_cell_size);
+  int left = cell_offset(x);
+  int top = cell_offset(y);
+  if (m_cell_size < lod_cell_size) {
+    //no grid lines, but every cell covers at least one pixel
+    return Rect(origin.x() + left + 1, origin.y() + top + 1,
+                std::max(cell_offset(x + 1) - left, 1),
+                std::max(cell_offset(y + 1) - top, 1));
+  }
+  return Rect(origin.x() + left + 1, origin.y() + top + 1,
+              m_cell_size, m_cell_size);
+}
+
+void PuzzlePanel::add_cell(CellBatch& batch, const Point& origin,
+                           int x, int y,
+                           PuzzleCell::State state,
+                           PuzzleCell::State prev_state,
+                           const Color& color,
+                           unsigned animation_time) const
+{
+  Rect dest = cell_rect(origin, x, y);
 
   if (x % 2 != y % 2)
-    renderer.set_draw_color(lightly_shaded_cell_color);
+    batch.backgrounds[2].push_back(dest);
   else if (x % 2 == 0)
-    renderer.set_draw_color(shaded_cell_color);
+    batch.backgrounds[1].push_back(dest);
   else
-    renderer.set_draw_color(blank_cell_color);
-  renderer.fill_rect(dest);
+    batch.backgrounds[0].push_back(dest);
 
   //change size of square based on time elapsed
   if (state != prev_state) {
@@ -367,60 +701,113 @@ void PuzzlePanel::draw_cell(Renderer& renderer, int x, int y,
     }
   }
 
-  if (state == PuzzleCell::State::filled) {
-    renderer.set_draw_color(color);
-    renderer.fill_rect(dest);
-  } else if (state == PuzzleCell::State::crossed_out) {
-    renderer.copy_texture(m_cell_texture, src, dest);
-  }
-
+  //a blank cell that is still animating shows its previous contents
   if (state == PuzzleCell::State::blank
-      && animation_time < cell_animation_duration) {
-    if (prev_state == PuzzleCell::State::filled) {
-      renderer.set_draw_color(color);
-      renderer.fill_rect(dest);
-    } else if (prev_state == PuzzleCell::State::crossed_out) {
-      renderer.copy_texture(m_cell_texture, src, dest);
+      && animation_time < cell_animation_duration)
+    state = prev_state;
+
+  if (state == PuzzleCell::State::filled)
+    batch.fills[color].push_back(dest);
+  else if (state == PuzzleCell::State::crossed_out)
+    batch.crosses.push_back(dest);
+}
+
+void PuzzlePanel::add_grid_lines(CellBatch& batch, const Point& origin,
+                                 int first_col, int last_col,
+                                 int first_row, int last_row) const
+{
+  int top = origin.y() + cell_offset(first_row);
+  int bottom = origin.y() + cell_offset(last_row);
+  int left = origin.x() + cell_offset(first_col);
+  int right = origin.x() + cell_offset(last_col);
+
+  //every fifth line is thick
+  constexpr int thickness = 3;
+  for (int x = first_col; x <= last_col; ++x) {
+    int pos = origin.x() + cell_offset(x);
+    if (x % 5 == 0) {
+      batch.thick_lines.push_back(Rect(pos - thickness / 2, top,
+                                       thickness, bottom - top + 1));
+    } else {
+      batch.thin_lines.push_back(Point(pos, top));
+      batch.thin_lines.push_back(Point(pos, bottom));
+    }
+  }
+  for (int y = first_row; y <= last_row; ++y) {
+    int pos = origin.y() + cell_offset(y);
+    if (y % 5 == 0) {
+      batch.thick_lines.push_back(Rect(left, pos - thickness / 2,
+                                       right - left + 1, thickness));
+    } else {
+      batch.thin_lines.push_back(Point(left, pos));
+      batch.thin_lines.push_back(Point(right, pos));
     }
   }
 }
 
+void PuzzlePanel::draw_cell_batch(Renderer& renderer,
+                                  const CellBatch& batch) const
+{
+  renderer.set_draw_color(blank_cell_color);
+  renderer.fill_rects(batch.backgrounds[0]);
+  renderer.set_draw_color(shaded_cell_color);
+  renderer.fill_rects(batch.backgrounds[1]);
+  renderer.set_draw_color(lightly_shaded_cell_color);
+  renderer.fill_rects(batch.backgrounds[2]);
+
+  for (const auto& fill : batch.fills) {
+    renderer.set_draw_color(fill.first);
+    renderer.fill_rects(fill.second);
+  }
+
+  int src_cell_size = m_cell_texture.height() / 3;
+  Rect src(0, 0, src_cell_size, src_cell_size);
+  renderer.copy_texture(m_cell_texture, src, batch.crosses);
+
+  renderer.set_draw_color(cell_border_color);
+  renderer.draw_lines(batch.thin_lines);
+  renderer.fill_rects(batch.thick_lines);
+}
+
 void PuzzlePanel::draw_selection(Renderer& renderer) const
 {
   if (m_selected) {
-    Rect cell(m_grid_pos.x() + m_selection_x * (m_cell_size + 1),
-              m_grid_pos.y() + m_selection_y * (m_cell_size + 1),
-              m_cell_size + 1, m_cell_size + 1);
+    int left = cell_offset(m_selection_x);
+    int top = cell_offset(m_selection_y);
+    Rect cell(m_grid_pos.x() + left, m_grid_pos.y() + top,
+              std::max(cell_offset(m_selection_x + 1) - left, 1),
+              std::max(cell_offset(m_selection_y + 1) - top, 1));
     renderer.set_draw_color(m_color);
     renderer.draw_thick_rect(cell, 3);
 
-    int src_size = m_cell_texture.height() / 3;
-    Rect dest(m_grid_pos.x() - m_cell_size - 1, cell.y(),
-              m_cell_size, m_cell_size);
-    Rect src(src_size, 0, src_size, src_size);
-    renderer.copy_texture(m_cell_texture, src, dest);
-
-    dest = Rect(cell.x(), m_grid_pos.y() - m_cell_size - 1,
+    //the row and column markers sit where the clues would be
+    if (m_cell_size >= lod_cell_size) {
+      int src_size = m_cell_texture.height() / 3;
+      Rect dest(m_grid_pos.x() - m_cell_size - 1, cell.y(),
                 m_cell_size, m_cell_size);
-    src = Rect(src_size * 2, 0, src_size, src_size);
-    renderer.copy_texture(m_cell_texture, src, dest);
+      Rect src(src_size, 0, src_size, src_size);
+      renderer.copy_texture(m_cell_texture, src, dest);
+
+      dest = Rect(cell.x(), m_grid_pos.y() - m_cell_size - 1,
+                  m_cell_size, m_cell_size);
+      src = Rect(src_size * 2, 0, src_size, src_size);
+      renderer.copy_texture(m_cell_texture, src, dest);
+    }
   }
 
   if ((m_mouse_dragging || m_kb_dragging)
       && m_draw_tool != DrawTool::paint
       && m_draw_tool != DrawTool::fill) {
-    if (m_drag_marks)
-      renderer.set_draw_color(m_color);
-    else
-      renderer.set_draw_color(default_colors::white);
-    auto fn = [this, &renderer](int x, int y) {
+    CellBatch batch;
+    auto fn = [this, &batch](int x, int y) {
       auto state = (m_drag_marks
                     ? PuzzleCell::State::filled
                     : PuzzleCell::State::blank);
-      draw_cell(renderer, x, y, state, state,
-                m_color, cell_animation_duration);
+      add_cell(batch, m_grid_pos, x, y, state, state,
+               m_color, cell_animation_duration);
     };
     for_each_point_on_selection(fn);
+    draw_cell_batch(renderer, batch);
   }
 }
 
@@ -430,18 +817,21 @@ void PuzzlePanel::draw_errors(Renderer& renderer) const
 
 void PuzzlePanel::draw_hints(Renderer& renderer) const
 {
+  if (m_cell_size < lod_cell_size)
+    return;
+
   int src_size = m_cell_texture.height() / 3;
   Rect dest, src;
   src = Rect(src_size, src_size, src_size, src_size);
   for (int j : m_hinted_rows) {
     dest = Rect(m_grid_pos.x() - m_cell_size,
-                m_grid_pos.y() + j * (m_cell_size + 1),
+                m_grid_pos.y() + cell_offset(j),
                 m_cell_size, m_cell_size);
     renderer.copy_texture(m_cell_texture, src, dest);
   }
   src = Rect(src_size * 2, src_size, src_size, src_size);
   for (int i : m_hinted_cols) {
-    dest = Rect(m_grid_pos.x() + i * (m_cell_size + 1),
+    dest = Rect(m_grid_pos.x() + cell_offset(i),
                 m_grid_pos.y() - m_cell_size,
                 m_cell_size, m_cell_size);
     renderer.copy_texture(m_cell_texture, src, dest);
@@ -461,23 +851,136 @@ void PuzzlePanel::move(int x, int y)
 
 void PuzzlePanel::update_cells(unsigned ticks)
 {
-  for (auto& time : m_cell_time) {
-    if (time < cell_animation_duration)
-      time += ticks;
-  }
+  for (auto& anim : m_animations)
+    anim.time += ticks;
+
+  auto finished = [this](const CellAnimation& anim) {
+    return anim.index >= m_cur_puzzle_size
+      || anim.time >= cell_animation_duration;
+  };
+  m_animations.erase(std::remove_if(m_animations.begin(),
+                                    m_animations.end(), finished),
+                     m_animations.end());
 }
 
 void PuzzlePanel::set_cell(int x, int y, PuzzleCell::State state)
 {
   int index = x + y * m_puzzle->width();
-  m_prev_cell_state[index] = (*m_puzzle)[x][y].state;
-  m_cell_time[index] = 0;
+  const PuzzleCell before = (*m_puzzle)[x][y];
+  PuzzleCell after = before;
+  after.state = state;
+  if (state == PuzzleCell::State::filled)
+    after.color = m_color;
+
+  animate_cell(index, before.state);
 
-  if (m_prev_cell_state[index] != state)
+  if (before != after)
     m_has_state_changed = true;
-  switch (state) {
+
+  //record the change for undo, unless the puzzle was changed some
+  //other way since the last step (a checkpoint will be saved then)
+  bool log_current = m_undo_revision == m_puzzle->revision();
+  put_cell(x, y, after);
+  std::size_t max_changes = m_cur_puzzle_size / 4 + 1;
+  if (log_current && m_pending_changes.size() < max_changes) {
+    if (before != after)
+      m_pending_changes.push_back({index, before, after});
+    m_undo_revision = m_puzzle->revision();
+  }
+}
+
+void PuzzlePanel::set_spans(const std::vector<Puzzle::Span>& spans,
+                            PuzzleCell::State state)
+{
+  //find the cells that actually change; spans must not overlap
+  std::vector<CellChange> changes;
+  int width = m_puzzle->width();
+  for (const auto& span : spans) {
+    const PuzzleCell* cells = m_puzzle->grid().row(span.row);
+    for (int x = span.begin; x < span.end; ++x) {
+      PuzzleCell after = cells[x];
+      after.state = state;
+      if (state == PuzzleCell::State::filled)
+        after.color = m_color;
+      if (cells[x] != after)
+        changes.push_back({x + span.row * width, cells[x], after});
+    }
+  }
+  if (changes.empty())
+    return;
+
+  bool layer_current = m_layer_revision == m_puzzle->revision();
+  bool lod_current = m_lod_revision == m_puzzle->revision();
+  bool log_current = m_undo_revision == m_puzzle->revision();
+  bool clues_current = m_edit_mode
+    && m_clue_layout_revision == m_puzzle->revision();
+
+  m_puzzle->set_spans(spans, state, m_color);
+  m_has_state_changed = true;
+
+  //same limits as set_cell and put_cell, applied to the whole batch
+  std::size_t max_cells = m_cur_puzzle_size / 4 + 1;
+  if (layer_current && m_dirty_cells.size() + changes.size() < max_cells) {
+    for (const auto& change : changes)
+      m_dirty_cells.push_back(change.index);
+    m_layer_revision = m_puzzle->revision();
+  }
+  if (lod_current
+      && m_lod_dirty_cells.size() + changes.size() < max_cells) {
+    for (const auto& change : changes)
+      m_lod_dirty_cells.push_back(change.index);
+    m_lod_revision = m_puzzle->revision();
+  }
+  if (log_current
+      && m_pending_changes.size() + changes.size() < max_cells) {
+    m_pending_changes.insert(m_pending_changes.end(),
+                             changes.begin(), changes.end());
+    m_undo_revision = m_puzzle->revision();
+  }
+  if (clues_current
+      && m_clue_dirty_rows.size() + changes.size() < max_cells) {
+    for (const auto& change : changes) {
+      m_clue_dirty_rows.push_back(change.index / width);
+      m_clue_dirty_cols.push_back(change.index % width);
+    }
+    m_clue_layout_revision = m_puzzle->revision();
+  }
+
+  //animating a huge batch costs more than it is worth
+  if (changes.size() <= max_bulk_animations)
+    for (const auto& change : changes)
+      animate_cell(change.index, change.before.state);
+}
+
+void PuzzlePanel::animate_cell(int index, PuzzleCell::State prev_state)
+{
+  //restart the animation if the cell is already animating; recently
+  //changed cells are at the back of the list
+  auto anim = std::find_if(m_animations.rbegin(), m_animations.rend(),
+                           [index](const CellAnimation& a) {
+                             return a.index == index;
+                           });
+  if (anim != m_animations.rend()) {
+    anim->time = 0;
+    anim->prev_state = prev_state;
+  } else
+    m_animations.push_back({index, 0, prev_state});
+}
+
+void PuzzlePanel::put_cell(int x, int y, const PuzzleCell& cell)
+{
+  int index = x + y * m_puzzle->width();
+
+  //if the cached cell layer or image is otherwise current, only this
+  //cell needs to be redrawn
+  bool layer_current = m_layer_revision == m_puzzle->revision();
+  bool lod_current = m_lod_revision == m_puzzle->revision();
+  bool clues_current = m_edit_mode
+    && m_clue_layout_revision == m_puzzle->revision();
+
+  switch (cell.state) {
   case PuzzleCell::State::filled:
-    m_puzzle->mark_cell(x, y, m_color);
+    m_puzzle->mark_cell(x, y, cell.color);
     break;
   default:
   case PuzzleCell::State::blank:
@@ -487,6 +990,22 @@ void PuzzlePanel::set_cell(int x, int y, PuzzleCell::State state)
     m_puzzle->cross_out_cell(x, y);
     break;
   };
+
+  //past a point it is cheaper to redraw everything
+  std::size_t max_dirty_cells = m_cur_puzzle_size / 4 + 1;
+  if (layer_current && m_dirty_cells.size() < max_dirty_cells) {
+    m_dirty_cells.push_back(index);
+    m_layer_revision = m_puzzle->revision();
+  }
+  if (lod_current && m_lod_dirty_cells.size() < max_dirty_cells) {
+    m_lod_dirty_cells.push_back(index);
+    m_lod_revision = m_puzzle->revision();
+  }
+  if (clues_current && m_clue_dirty_rows.size() < max_dirty_cells) {
+    m_clue_dirty_rows.push_back(y);
+    m_clue_dirty_cols.push_back(x);
+    m_clue_layout_revision = m_puzzle->revision();
+  }
 }
 
 void PuzzlePanel::drag_over_cell(int x, int y)
@@ -774,8 +1293,7 @@ void PuzzlePanel::handle_mouse_wheel(unsigned ticks, InputHandler& input)
 void PuzzlePanel::handle_resize()
 {
   m_cur_puzzle_size = m_puzzle->width() * m_puzzle->height();
-  m_cell_time.resize(m_cur_puzzle_size, cell_animation_duration);
-  m_prev_cell_state.resize(m_cur_puzzle_size, PuzzleCell::State::blank);
+  m_animations.clear();
 
   m_selection_x = 0;
   m_selection_y = 0;
@@ -801,16 +1319,8 @@ void PuzzlePanel::do_draw_action(bool mark)
   case DrawTool::line:
   case DrawTool::rect:
   case DrawTool::ellipse:
-    {
-      auto f = [this, mark](int x, int y) {
-        if (mark)
-          m_puzzle->mark_cell(x, y, m_color);
-        else
-          m_puzzle->clear_cell(x, y);
-        m_has_state_changed = true;
-      };
-      for_each_point_on_selection(f);
-    }
+    set_spans(selection_spans(), mark ? PuzzleCell::State::filled
+              : PuzzleCell::State::blank);
     break;
   case DrawTool::fill:
     {
@@ -830,44 +1340,98 @@ void PuzzlePanel::do_draw_action(bool mark)
               && target_color == replace_color))
         break;
 
-      std::queue<Point> queue;
-      queue.push(Point(m_selection_x, m_selection_y));
-
-      auto test_point = [=](int x, int y) -> bool {
-        if (x < 0 || x >= m_puzzle->width()
-            || y < 0 || y >= m_puzzle->height())
-          return false;
-        if ((*m_puzzle)[x][y].state != target_state)
-          return false;
-        if (target_state == fill
-            && (*m_puzzle)[x][y].color != target_color)
-          return false;
-        return true;
-      };
-
-      while (!queue.empty()) {
-        Point n = queue.front();
-        queue.pop();
-
-        Point w = n, e = n;
-        while (test_point(w.x(), w.y()))
-          --w.x();
-        while (test_point(e.x(), e.y()))
-          ++e.x();
-
-        for (int x = w.x() + 1; x < e.x(); ++x) {
-          set_cell(x, w.y(), replace_state);
-          if (test_point(x, w.y() - 1))
-            queue.push(Point(x, w.y() - 1));
-          if (test_point(x, w.y() + 1))
-            queue.push(Point(x, w.y() + 1));
-        }
-      }
+      set_spans(fill_spans(m_selection_x, m_selection_y), replace_state);
     }
     break;
   }
 }
 
+std::vector<Puzzle::Span> PuzzlePanel::selection_spans() const
+{
+  std::vector<Point> points;
+  for_each_point_on_selection([&points](int x, int y) {
+      points.push_back(Point(x, y));
+    });
+
+  std::sort(points.begin(), points.end(),
+            [](const Point& l, const Point& r) {
+              return l.y() < r.y() || (l.y() == r.y() && l.x() < r.x());
+            });
+  auto same = [](const Point& l, const Point& r) {
+    return l.x() == r.x() && l.y() == r.y();
+  };
+  points.erase(std::unique(points.begin(), points.end(), same),
+               points.end());
+
+  //join horizontally adjacent points
+  std::vector<Puzzle::Span> spans;
+  for (const auto& p : points) {
+    if (!spans.empty() && spans.back().row == p.y()
+        && spans.back().end == p.x())
+      ++spans.back().end;
+    else
+      spans.push_back({p.y(), p.x(), p.x() + 1});
+  }
+  return spans;
+}
+
+std::vector<Puzzle::Span> PuzzlePanel::fill_spans(int x, int y) const
+{
+  const PuzzleGrid& grid = m_puzzle->grid();
+  int width = grid.width();
+  int height = grid.height();
+  const PuzzleCell target = grid.at(x, y);
+
+  //cells already covered by a span are not revisited
+  std::vector<bool> visited(width * height, false);
+  auto matches = [&](const PuzzleCell* cells, int col, int row) {
+    const PuzzleCell& cell = cells[col];
+    return !visited[col + row * width] && cell.state == target.state
+      && (cell.state != PuzzleCell::State::filled
+          || cell.color == target.color);
+  };
+
+  std::vector<Puzzle::Span> spans;
+  std::vector<Point> seeds;
+  seeds.push_back(Point(x, y));
+  while (!seeds.empty()) {
+    Point seed = seeds.back();
+    seeds.pop_back();
+
+    int row = seed.y();
+    const PuzzleCell* cells = grid.row(row);
+    if (!matches(cells, seed.x(), row))
+      continue;
+
+    int begin = seed.x(), end = seed.x() + 1;
+    while (begin > 0 && matches(cells, begin - 1, row))
+      --begin;
+    while (end < width && matches(cells, end, row))
+      ++end;
+
+    std::fill(visited.begin() + begin + row * width,
+              visited.begin() + end + row * width, true);
+    spans.push_back({row, begin, end});
+
+    //seed each run of matching cells in the neighboring rows
+    for (int adj_row : { row - 1, row + 1 }) {
+      if (adj_row < 0 || adj_row >= height)
+        continue;
+
+      const PuzzleCell* adj_cells = grid.row(adj_row);
+      bool in_run = false;
+      for (int col = begin; col < end; ++col) {
+        bool match = matches(adj_cells, col, adj_row);
+        if (match && !in_run)
+          seeds.push_back(Point(col, adj_row));
+        in_run = match;
+      }
+    }
+  }
+
+  return spans;
+}
+
 void PuzzlePanel::for_each_point_on_selection(CellFunction fn) const
 {
   int x0 = m_drag_start_x;
@@ -1073,10 +1637,8 @@ void PuzzlePanel::update_zoom(unsigned ticks)
     delta = 1;
 
   //calculate grid pos of zoom target
-  double zoom_pos_x = (m_zoom_target_x - m_grid_pos.x())
-    / static_cast<double>(m_cell_size + 1);
-  double zoom_pos_y = (m_zoom_target_y - m_grid_pos.y())
-    / static_cast<double>(m_cell_size + 1);
+  double zoom_pos_x = (m_zoom_target_x - m_grid_pos.x()) / m_pitch;
+  double zoom_pos_y = (m_zoom_target_y - m_grid_pos.y()) / m_pitch;
 
   //update cell size
   if (m_cell_size < m_target_cell_size) {
@@ -1090,13 +1652,12 @@ void PuzzlePanel::update_zoom(unsigned ticks)
   }
 
   //resize the font and recalculate boundaries
-  update_clue_font();
   calc_grid_pos();
 
   int new_target_x = static_cast<int>(m_grid_pos.x()
-                                      + zoom_pos_x * (m_cell_size + 1));
+                                      + zoom_pos_x * m_pitch);
   int new_target_y = static_cast<int>(m_grid_pos.y()
-                                      + zoom_pos_y * (m_cell_size + 1));
+                                      + zoom_pos_y * m_pitch);
   scroll(m_zoom_target_x - new_target_x, m_zoom_target_y - new_target_y);
 }
 
@@ -1111,104 +1672,125 @@ void PuzzlePanel::save_undo_state()
 {
   m_has_state_changed = false;
 
+  //if every change since the last step was recorded, the step only
+  //needs the changed cells
+  bool is_diff = !m_state_history.empty()
+    && m_undo_revision == m_puzzle->revision();
+  if (is_diff && m_pending_changes.empty())
+    return;
+
+  //discard the redo history
   if (!m_state_history.empty())
-    ++m_cur_state;
-  if (m_cur_state != m_state_history.end())
-    m_state_history.erase(m_cur_state, m_state_history.end());
-  if (m_state_history.size() >= max_undo_size)
-    m_state_history.erase(m_state_history.begin());
+    m_state_history.erase(std::next(m_cur_state), m_state_history.end());
+
+  UndoStep step;
+  step.is_diff = is_diff;
+  step.changes = std::move(m_pending_changes);
+  if (!is_diff || ++m_steps_since_checkpoint >= undo_checkpoint_interval) {
+    step.checkpoint.reset(new CompressedState());
+    m_puzzle->copy_state(*step.checkpoint);
+    m_steps_since_checkpoint = 0;
+  }
   m_cur_state = m_state_history.insert(m_state_history.end(),
-                                       CompressedState());
-  m_puzzle->copy_state(*m_cur_state);
+                                       std::move(step));
+  m_pending_changes.clear();
+  m_undo_revision = m_puzzle->revision();
+
+  //drop old steps, keeping a checkpoint at the front
+  if (m_state_history.size() > max_undo_size) {
+    auto front = std::next(m_state_history.begin());
+    while (front != m_state_history.end() && !front->checkpoint)
+      ++front;
+    if (front != m_state_history.end())
+      m_state_history.erase(m_state_history.begin(), front);
+  }
 }
 
 void PuzzlePanel::load_undo_state()
 {
-  if (m_cur_state != m_state_history.end()) {
-    m_puzzle->load_state(*m_cur_state);
-    if (m_cur_puzzle_size != m_puzzle->width() * m_puzzle->height())
-      handle_resize();
+  if (m_cur_state == m_state_history.end())
+    return;
+
+  auto step = m_cur_state;
+  while (!step->checkpoint)
+    --step;
+
+  m_puzzle->load_state(*step->checkpoint);
+  if (m_cur_puzzle_size != m_puzzle->width() * m_puzzle->height())
+    handle_resize();
+
+  //replay the steps recorded since the checkpoint
+  while (step != m_cur_state) {
+    ++step;
+    for (const auto& change : step->changes)
+      put_cell(change.index % m_puzzle->width(),
+               change.index / m_puzzle->width(), change.after);
   }
 }
 
 void PuzzlePanel::undo()
 {
-  if (m_cur_state != m_state_history.begin()) {
-    --m_cur_state;
+  if (m_has_state_changed)
+    save_undo_state();
+
+  if (m_state_history.empty() || m_cur_state == m_state_history.begin())
+    return;
+
+  auto step = m_cur_state--;
+  if (step->is_diff) {
+    for (auto it = step->changes.rbegin(); it != step->changes.rend(); ++it)
+      put_cell(it->index % m_puzzle->width(),
+               it->index / m_puzzle->width(), it->before);
+  } else {
     load_undo_state();
   }
+
+  m_pending_changes.clear();
+  m_undo_revision = m_puzzle->revision();
 }
 
 void PuzzlePanel::redo()
 {
-  if (m_cur_state != m_state_history.end()) {
-    ++m_cur_state;
-    if (m_cur_state != m_state_history.end())
-      load_undo_state();
-    else
-      --m_cur_state;
+  if (m_has_state_changed)
+    save_undo_state();
+
+  if (m_state_history.empty()
+      || std::next(m_cur_state) == m_state_history.end())
+    return;
+
+  ++m_cur_state;
+  if (m_cur_state->is_diff) {
+    for (const auto& change : m_cur_state->changes)
+      put_cell(change.index % m_puzzle->width(),
+               change.index / m_puzzle->width(), change.after);
+  } else {
+    load_undo_state();
   }
+
+  m_pending_changes.clear();
+  m_undo_revision = m_puzzle->revision();
 }
 
 void PuzzlePanel::toggle_hints()
 {
-  if (!m_hinted_rows.empty() || !m_hinted_cols.empty())
+  if (!m_hinted_rows.empty() || !m_hinted_cols.empty()
+      || m_hint_task.is_busy())
     clear_hints();
-  else {
-    update_hints(true);
-
-    //if nothing was found, do an exhaustive check
-    if (m_hinted_rows.empty() && m_hinted_cols.empty())
-      update_hints(false);
-  }
+  else if (m_puzzle)
+    m_hint_task.start(*m_puzzle);
 }
 
 void PuzzlePanel::clear_hints()
 {
+  m_hint_task.cancel();
   m_hinted_rows.clear();
   m_hinted_cols.clear();
 }
 
-bool PuzzlePanel::can_line_be_further_solved(PuzzleLine line,
-                                             bool fast_check)
+void PuzzlePanel::update_hints()
 {
-  LineSolver ls(line);
-  std::vector<PuzzleCell> result;
-
-  bool solvable = false;
-  if (fast_check)
-    solvable = ls.solve_fast(result);
-  else
-    solvable = ls.solve_complete(result);
-
-  if (!solvable)
-    return false;
-
-  //see if solver found anything
-  for (int i = 0; i < line.size(); ++i) {
-    if (result[i].state != PuzzleCell::State::blank
-        && (line[i].state != result[i].state
-            || (result[i].state == PuzzleCell::State::filled
-                && line[i].color != result[i].color)))
-      return true;
-  }
-
-  //no differences found
-  return false;
-}
-
-void PuzzlePanel::update_hints(bool fast)
-{
-  if (m_puzzle) {
-    for (int i = 0; i < m_puzzle->width(); ++i) {
-      PuzzleLine line = m_puzzle->get_col(i);
-      if (can_line_be_further_solved(line, fast))
-        m_hinted_cols.insert(i);
-    }
-    for (int j = 0; j < m_puzzle->height(); ++j) {
-      PuzzleLine line = m_puzzle->get_row(j);
-      if (can_line_be_further_solved(line, fast))
-        m_hinted_rows.insert(j);
-    }
-  }
+  std::vector<int> rows, cols;
+  m_hint_task.take_hints(rows, cols);
+  m_hinted_rows.insert(rows.begin(), rows.end());
+  m_hinted_cols.insert(cols.begin(), cols.end());
 }
@@ -21,16 +21,22 @@
 #ifndef NONNY_PUZZLE_PANEL_HPP
 #define NONNY_PUZZLE_PANEL_HPP
 
+#include <cmath>
 #include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <vector>
 #include "color/color_palette.hpp"
 #include "puzzle/compressed_state.hpp"
 #include "puzzle/puzzle.hpp"
 #include "puzzle/puzzle_cell.hpp"
+#include "solver/hint_task.hpp"
 #include "ui/ui_panel.hpp"
 #include "video/point.hpp"
+#include "video/rect.hpp"
 
 class Font;
 class InputHandler;
@@ -76,6 +82,9 @@ public:
   void toggle_hints();
   void clear_hints();
 
+  // Determine whether anything is changing from frame to frame
+  inline bool is_animating() const;
+
   bool is_save_needed() const { return m_need_save; }
   void clear_save_flag() { m_need_save = false; }
 
@@ -89,21 +98,76 @@ public:
 
 private:
   void calc_grid_pos();
-  int row_clue_width(int row) const;
-  int col_clue_height(int col) const;
+
+  //offset of the grid line before cell i from the grid position
+  int cell_offset(int i) const
+    { return static_cast<int>(std::floor(i * m_pitch)); }
+  //index of the cell containing an offset from the grid position
+  int cell_index(int offset) const
+    { return static_cast<int>(offset / m_pitch); }
+  //screen area covered by a cell, excluding its grid lines
+  Rect cell_rect(const Point& origin, int x, int y) const;
+
+  //measure every clue and lay out each line of clues
+  void update_clue_layout();
+  //lay out again only the lines whose cells were edited
+  void update_clue_lines();
+  int row_clue_width(int row) const { return m_clue_layout.rows[row].size; }
+  int col_clue_height(int col) const { return m_clue_layout.cols[col].size; }
   int clue_spacing() const { return m_cell_size / 3; }
-  void draw_grid_lines(Renderer& renderer) const;
-  void draw_clues(Renderer& renderer) const;
-  void draw_cells(Renderer& renderer) const;
-  void draw_cell(Renderer& renderer, int x, int y,
-                 PuzzleCell::State state, PuzzleCell::State prev_state,
-                 const Color& color, unsigned animation_time) const;
+
+  //find the range of columns [*first_col, *last_col) and rows
+  //[*first_row, *last_row) that overlap the given region
+  void visible_cells(const Rect& region, int* first_col, int* last_col,
+                     int* first_row, int* last_row) const;
+
+  void draw_clues(Renderer& renderer, const Rect& region) const;
+
+  /*
+   * Draw the cells and grid lines. The finished cells are kept in a
+   * texture covering the visible part of the grid; only cells that
+   * have changed are redrawn into it, and cells that are still
+   * animating are drawn on top.
+   */
+  void draw_cell_layer(Renderer& renderer, const Rect& region) const;
+
+  //draw the puzzle as a scaled image at low zoom levels, or as
+  //rectangles if the renderer cannot provide one
+  void draw_lod_image(Renderer& renderer, int first_col, int last_col,
+                      int first_row, int last_row) const;
+
+  //cell drawing is batched: cells are added to a CellBatch, which
+  //groups them by fill color so that each group is drawn in one call
+  struct CellBatch {
+    std::vector<Rect> backgrounds[3]; //blank, shaded, lightly shaded
+    std::map<Color, std::vector<Rect>> fills;
+    std::vector<Rect> crosses;
+    std::vector<Point> thin_lines;
+    std::vector<Rect> thick_lines;
+  };
+  //add a cell to the batch, with origin giving the grid position
+  void add_cell(CellBatch& batch, const Point& origin, int x, int y,
+                PuzzleCell::State state, PuzzleCell::State prev_state,
+                const Color& color, unsigned animation_time) const;
+  //add the grid lines surrounding the given range of cells
+  void add_grid_lines(CellBatch& batch, const Point& origin,
+                      int first_col, int last_col,
+                      int first_row, int last_row) const;
+  void draw_cell_batch(Renderer& renderer, const CellBatch& batch) const;
+  //draw the cells in the given range that are still animating
+  void draw_cell_animations(Renderer& renderer, int first_col, int last_col,
+                            int first_row, int last_row) const;
   void draw_selection(Renderer& renderer) const;
   void draw_errors(Renderer& renderer) const;
   void draw_hints(Renderer& renderer) const;
 
   void update_cells(unsigned ticks);
   void set_cell(int x, int y, PuzzleCell::State state);
+  //set many cells as one change, with a single update of the dirty
+  //lists and undo log
+  void set_spans(const std::vector<Puzzle::Span>& spans,
+                 PuzzleCell::State state);
+  void animate_cell(int index, PuzzleCell::State prev_state);
   void drag_over_cell(int x, int y);
   void handle_mouse_selection(unsigned ticks, InputHandler& input,
                               const Rect& region);
@@ -117,6 +181,10 @@ private:
   typedef std::function<void(int, int)> CellFunction;
   void for_each_point_on_selection(CellFunction fn) const;
   void call_on_point(CellFunction fn, int x, int y) const;
+  //the cells of the current line, rect or ellipse, joined into spans
+  std::vector<Puzzle::Span> selection_spans() const;
+  //the region a flood fill from (x, y) would cover
+  std::vector<Puzzle::Span> fill_spans(int x, int y) const;
 
   enum class Direction { up, down, left, right };
   void move_selection(Direction dir, int count = 1);
@@ -131,11 +199,15 @@ private:
   void update_zoom(unsigned ticks);
   void zoom_to(int amount, int x, int y);
 
+  //commit the changes since the last call as one undo step
   void save_undo_state();
+  //load the state at m_cur_state, starting from the nearest checkpoint
   void load_undo_state();
+  //set a cell without animating it or recording it for undo
+  void put_cell(int x, int y, const PuzzleCell& cell);
 
-  bool can_line_be_further_solved(PuzzleLine line, bool fast_check = true);
-  void update_hints(bool fast = true);
+  //add lines found by the hint task since the last update
+  void update_hints();
 
   enum class DragType { fill, cross, blanking_fill, blanking_cross };
 
@@ -145,10 +217,22 @@ private:
   //Puzzle information
   Puzzle* m_puzzle = nullptr;
   Color m_color;
-  std::vector<unsigned> m_cell_time;
-  std::vector<PuzzleCell::State> m_prev_cell_state;
+
+  //only cells that are still animating are tracked, so the cost of
+  //animation does not grow with the size of the puzzle
+  struct CellAnimation {
+    int index;
+    unsigned time;
+    PuzzleCell::State prev_state;
+  };
+  std::vector<CellAnimation> m_animations;
+
   int m_cell_size = 32;
   int m_target_cell_size = 32;
+  //distance between neighbouring grid lines: m_cell_size + 1, except
+  //at low zoom levels where it is scaled to fit the puzzle to m_viewport
+  double m_pitch = 33;
+  Rect m_viewport;
   int m_zoom_target_x = 0;
   int m_zoom_target_y = 0;
   Point m_clue_pos;
@@ -161,14 +245,71 @@ private:
   //Needed to detect size changes in edit mode
   int m_cur_puzzle_size = 0;
 
-  //Undo/redo
-  std::list<CompressedState> m_state_history;
-  std::list<CompressedState>::iterator m_cur_state;
+  //Undo/redo. Each step lists the cells it changed; a step also keeps
+  //a checkpoint of the whole grid if it came from a change that was
+  //not recorded cell by cell, or periodically to bound replaying.
+  //The first step always has a checkpoint.
+  struct CellChange {
+    int index;
+    PuzzleCell before;
+    PuzzleCell after;
+  };
+  struct UndoStep {
+    std::vector<CellChange> changes;
+    std::unique_ptr<CompressedState> checkpoint;
+    bool is_diff = true; //false if only the checkpoint is valid
+  };
+  std::list<UndoStep> m_state_history;
+  std::list<UndoStep>::iterator m_cur_state;
+  std::vector<CellChange> m_pending_changes;
+  unsigned long m_undo_revision = 0; //puzzle revision the log accounts for
+  int m_steps_since_checkpoint = 0;
   bool m_has_state_changed = true;
 
+  //Clue layout, rebuilt when the puzzle, zoom level or font changes.
+  //Editing a cell only marks its row and column in m_clue_dirty_rows
+  //and m_clue_dirty_cols, which are laid out again on their own.
+  struct ClueLayout {
+    struct Entry {
+      std::string text;
+      int offset; //distance from the start of the line
+      int width;
+      int height;
+    };
+    struct Line {
+      std::vector<Entry> entries;
+      int size = 0; //total width of a row's or height of a column's clues
+    };
+    std::vector<Line> rows;
+    std::vector<Line> cols;
+  } m_clue_layout;
+  unsigned long m_clue_layout_revision = 0;
+  std::vector<int> m_clue_dirty_rows;
+  std::vector<int> m_clue_dirty_cols;
+  //measure the clues of one line
+  void layout_clue_line(const Puzzle::ClueSequence& clues, bool horizontal,
+                        ClueLayout::Line& line) const;
+
+  //Cached cell layer: m_layer holds the cells in m_layer_area as of
+  //puzzle revision m_layer_revision, except for m_dirty_cells
+  mutable std::unique_ptr<Texture> m_layer;
+  mutable Rect m_layer_area;
+  mutable Point m_layer_grid_pos;
+  mutable int m_layer_cell_size = 0;
+  mutable unsigned long m_layer_revision = 0;
+  mutable std::vector<int> m_dirty_cells;
+
+  //Image of the puzzle for low zoom levels, one pixel per cell
+  mutable std::unique_ptr<Texture> m_lod_image;
+  mutable unsigned long m_lod_revision = 0;
+  mutable std::vector<int> m_lod_dirty_cells;
+  //renderer target generation both textures were drawn in
+  mutable unsigned long m_target_generation = 0;
+
   //Hints
   std::set<int> m_hinted_rows;
   std::set<int> m_hinted_cols;
+  HintTask m_hint_task; //finds hints in the background
 
   //Dragging states
   DragType m_mouse_drag_type = DragType::fill;
@@ -197,14 +338,19 @@ private:
 
 /* implementation */
 
+inline bool PuzzlePanel::is_animating() const
+{
+  return !m_animations.empty() || m_cell_size != m_target_cell_size
+    || m_has_state_changed || m_hint_task.is_busy();
+}
+
 inline bool PuzzlePanel::is_point_in_grid(const Point& p) const
 {
-  const int cell_size = m_cell_size;
   const int width = m_puzzle->width();
   const int height = m_puzzle->height();
   return p.x() > m_grid_pos.x() && p.y() > m_grid_pos.y()
-    && p.x() <= m_grid_pos.x() + width * (cell_size + 1)
-    && p.y() <= m_grid_pos.y() + height * (cell_size + 1);
+    && p.x() <= m_grid_pos.x() + cell_offset(width)
+    && p.y() <= m_grid_pos.y() + cell_offset(height);
 }
 
 inline void PuzzlePanel::cell_at_point(const Point& p,
@@ -214,7 +360,7 @@ inline void PuzzlePanel::cell_at_point(const Point& p,
     if (p.x() < m_grid_pos.x() + 1)
       *x = 0;
     else
-      *x = (p.x() - m_grid_pos.x() - 1) / (m_cell_size + 1);
+      *x = cell_index(p.x() - m_grid_pos.x() - 1);
 
     if (*x >= m_puzzle->width())
       *x = m_puzzle->width() - 1;
@@ -223,7 +369,7 @@ inline void PuzzlePanel::cell_at_point(const Point& p,
     if (p.y() < m_grid_pos.y() + 1)
       *y = 0;
     else
-      *y = (p.y() - m_grid_pos.y() - 1) / (m_cell_size + 1);
+      *y = cell_index(p.y() - m_grid_pos.y() - 1);
 
     if (*y >= m_puzzle->height())
       *y = m_puzzle->height() - 1;
@@ -234,9 +380,9 @@ inline void PuzzlePanel::generalized_cell_at_point(const Point&p,
                                                    int* x, int* y) const
 {
   if (x)
-    *x = (p.x() - m_grid_pos.x() - 1) / (m_cell_size + 1);
+    *x = cell_index(p.x() - m_grid_pos.x() - 1);
   if (y)
-    *y = (p.y() - m_grid_pos.y() - 1) / (m_cell_size + 1);
+    *y = cell_index(p.y() - m_grid_pos.y() - 1);
 }
 
 #endif
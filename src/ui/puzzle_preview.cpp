@@ -20,7 +20,6 @@
 
 #include "ui/puzzle_preview.hpp"
 
-#include <algorithm>
 #include "puzzle/puzzle.hpp"
 #include "video/renderer.hpp"
 
@@ -38,35 +37,11 @@ void PuzzlePreview::draw(Renderer& renderer, const Rect& region) const
     renderer.set_draw_color(default_colors::white);
     renderer.fill_rect(m_boundary);
 
-    //calculate sizes and offsets
-    int p_width = m_puzzle->width();
-    int p_height = m_puzzle->height();
-    int horiz_pixel_size = 0, vert_pixel_size = 0;
-    if (p_width)
-      horiz_pixel_size = m_boundary.width() / m_puzzle->width();
-    if (p_height)
-      vert_pixel_size = m_boundary.height() / m_puzzle->height();
-    int pixel_size = std::min(horiz_pixel_size, vert_pixel_size);
-    Point start(m_boundary.x() + m_boundary.width() / 2
-                - pixel_size * m_puzzle->width() / 2,
-                m_boundary.y() + m_boundary.height() / 2
-                - pixel_size * m_puzzle->height() / 2);
-
-    //draw the "pixels"
-    for (int y = 0; y < m_puzzle->height(); ++y) {
-      for (int x = 0; x < m_puzzle->width(); ++x) {
-        auto cell = (*m_puzzle)[x][y];
-
-        if (cell.state == PuzzleCell::State::filled) {
-          renderer.set_draw_color(cell.color);
-
-          Rect r(start.x() + x * pixel_size,
-                 start.y() + y * pixel_size,
-                 pixel_size, pixel_size);
-          renderer.fill_rect(r);
-        }
-      }
+    if (m_thumbnail_revision != m_puzzle->revision()) {
+      m_thumbnail.update(renderer, *m_puzzle, default_colors::white);
+      m_thumbnail_revision = m_puzzle->revision();
     }
+    m_thumbnail.draw(renderer, m_boundary);
 
     renderer.set_clip_rect();
   }
@@ -21,6 +21,7 @@
 #ifndef NONNY_PUZZLE_PREVIEW_HPP
 #define NONNY_PUZZLE_PREVIEW_HPP
 
+#include "ui/puzzle_thumbnail.hpp"
 #include "ui/ui_panel.hpp"
 
 class Puzzle;
@@ -43,6 +44,10 @@ public:
 
 private:
   const Puzzle* m_puzzle = nullptr;
+
+  //rebuilt whenever the puzzle's revision changes
+  mutable PuzzleThumbnail m_thumbnail;
+  mutable unsigned long m_thumbnail_revision = 0;
 };
 
 #endif
@@ -0,0 +1,101 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "ui/puzzle_thumbnail.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include "video/renderer.hpp"
+
+void PuzzleThumbnail::draw(Renderer& renderer, const Rect& area) const
+{
+  if (!m_width || !m_height || area.width() <= 0 || area.height() <= 0)
+    return;
+
+  //whole pixels per cell when they fit, otherwise a fraction
+  double scale = std::min(area.width() / static_cast<double>(m_width),
+                          area.height() / static_cast<double>(m_height));
+  if (scale >= 1.0)
+    scale = std::floor(scale);
+  int width = std::max(static_cast<int>(scale * m_width), 1);
+  int height = std::max(static_cast<int>(scale * m_height), 1);
+
+  Rect dest(area.x() + area.width() / 2 - width / 2,
+            area.y() + area.height() / 2 - height / 2,
+            width, height);
+
+  if (m_texture) {
+    renderer.copy_texture(*m_texture, Rect(), dest);
+    return;
+  }
+
+  //no streaming textures available: fill the background once, then
+  //the remaining pixels with one call per color
+  Color background(m_background >> 24, (m_background >> 16) & 0xff,
+                   (m_background >> 8) & 0xff);
+  renderer.set_draw_color(background);
+  renderer.fill_rect(dest);
+
+  auto offset = [scale](int i) {
+    return static_cast<int>(std::floor(i * scale));
+  };
+  std::map<std::uint32_t, std::vector<Rect>> fills;
+  for (int y = 0; y < m_height; ++y) {
+    for (int x = 0; x < m_width; ++x) {
+      std::uint32_t p = m_pixels[y * m_width + x];
+      if (p == m_background)
+        continue;
+
+      fills[p].push_back(Rect(dest.x() + offset(x), dest.y() + offset(y),
+                              std::max(offset(x + 1) - offset(x), 1),
+                              std::max(offset(y + 1) - offset(y), 1)));
+    }
+  }
+  for (const auto& fill : fills) {
+    std::uint32_t p = fill.first;
+    renderer.set_draw_color(Color(p >> 24, (p >> 16) & 0xff,
+                                  (p >> 8) & 0xff));
+    renderer.fill_rects(fill.second);
+  }
+}
+
+void PuzzleThumbnail::clear()
+{
+  m_width = m_height = 0;
+  m_pixels.clear();
+  m_texture.reset();
+}
+
+void PuzzleThumbnail::upload(Renderer& renderer)
+{
+  if (!m_width || !m_height) {
+    m_texture.reset();
+    return;
+  }
+
+  if (!m_texture || m_texture->width() != m_width
+      || m_texture->height() != m_height)
+    m_texture = renderer.new_streaming_texture(m_width, m_height);
+
+  if (m_texture)
+    renderer.update_texture(*m_texture, Rect(0, 0, m_width, m_height),
+                            m_pixels.data());
+}
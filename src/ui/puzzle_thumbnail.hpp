@@ -0,0 +1,99 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_PUZZLE_THUMBNAIL_HPP
+#define NONNY_PUZZLE_THUMBNAIL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "color/color.hpp"
+#include "puzzle/puzzle_cell.hpp"
+#include "video/rect.hpp"
+#include "video/texture.hpp"
+
+class Renderer;
+
+/*
+ * A small picture of a puzzle grid with one pixel per cell, uploaded
+ * to a texture once and then scaled up whenever it is drawn. Filled
+ * cells take their own color and everything else is drawn in the
+ * background color.
+ */
+class PuzzleThumbnail {
+public:
+  //rebuild the image from grid, which may be a Puzzle or a PuzzleGrid
+  template <typename Grid>
+  void update(Renderer& renderer, const Grid& grid,
+              const Color& background);
+
+  //draw the image centered in area, scaled by a whole number, or
+  //shrunk to fit if the area has fewer pixels than the grid has cells
+  void draw(Renderer& renderer, const Rect& area) const;
+
+  void clear();
+  bool empty() const { return m_pixels.empty(); }
+
+private:
+  static std::uint32_t pack(const Color& color);
+  void upload(Renderer& renderer);
+
+  int m_width = 0;
+  int m_height = 0;
+  std::vector<std::uint32_t> m_pixels;
+  std::uint32_t m_background = 0;
+  std::unique_ptr<Texture> m_texture;
+};
+
+
+/* implementation */
+
+template <typename Grid>
+void PuzzleThumbnail::update(Renderer& renderer, const Grid& grid,
+                             const Color& background)
+{
+  m_width = grid.width();
+  m_height = grid.height();
+
+  std::uint32_t bg_pixel = pack(background);
+  m_background = bg_pixel;
+  m_pixels.clear();
+  m_pixels.reserve(m_width * m_height);
+  for (int y = 0; y < m_height; ++y) {
+    for (int x = 0; x < m_width; ++x) {
+      const PuzzleCell& cell = grid.at(x, y);
+      if (cell.state == PuzzleCell::State::filled)
+        m_pixels.push_back(pack(cell.color));
+      else
+        m_pixels.push_back(bg_pixel);
+    }
+  }
+
+  upload(renderer);
+}
+
+inline std::uint32_t PuzzleThumbnail::pack(const Color& color)
+{
+  return static_cast<std::uint32_t>(color.red()) << 24
+    | static_cast<std::uint32_t>(color.green()) << 16
+    | static_cast<std::uint32_t>(color.blue()) << 8 | 0xff;
+}
+
+#endif
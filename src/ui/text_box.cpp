@@ -46,6 +46,13 @@ void TextBox::select_all()
   m_cursor = m_sel_length = m_text.size();
 }
 
+unsigned TextBox::time_until_blink() const
+{
+  if (m_cursor_duration >= cursor_blink_duration)
+    return 0;
+  return cursor_blink_duration - m_cursor_duration;
+}
+
 void TextBox::update(unsigned ticks, InputHandler& input,
                      const Rect& active_region)
 {
@@ -38,6 +38,9 @@ public:
 
   void select_all();
 
+  //milliseconds until the cursor next blinks
+  unsigned time_until_blink() const;
+
   using UIPanel::update;
   using UIPanel::draw;
   void update(unsigned ticks, InputHandler& input,
@@ -0,0 +1,111 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "utility/binary_io.hpp"
+
+#include <istream>
+#include <stdexcept>
+
+std::string& put_varint(std::string& buf, std::uint64_t value)
+{
+  while (value >= 0x80) {
+    buf.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<char>(value));
+  return buf;
+}
+
+std::string& put_string(std::string& buf, const std::string& str)
+{
+  put_varint(buf, str.size());
+  return buf.append(str);
+}
+
+std::string& put_uint64(std::string& buf, std::uint64_t value)
+{
+  for (int i = 0; i < 8; ++i)
+    buf.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  return buf;
+}
+
+std::uint64_t read_varint(std::istream& is)
+{
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int c = is.get();
+    if (c == std::istream::traits_type::eof())
+      throw std::runtime_error("::read_varint: unexpected end of file");
+
+    value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80))
+      return value;
+  }
+  throw std::runtime_error("::read_varint: invalid integer");
+}
+
+unsigned char ByteReader::byte()
+{
+  if (m_pos == m_end)
+    throw std::runtime_error("ByteReader::byte: unexpected end of data");
+  return static_cast<unsigned char>(*m_pos++);
+}
+
+std::uint64_t ByteReader::varint()
+{
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    unsigned char b = byte();
+    value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return value;
+  }
+  throw std::runtime_error("ByteReader::varint: invalid integer");
+}
+
+std::uint64_t ByteReader::uint64()
+{
+  const char* p = bytes(8);
+  std::uint64_t value = 0;
+  for (int i = 0; i < 8; ++i)
+    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i]))
+      << (8 * i);
+  return value;
+}
+
+std::string ByteReader::string()
+{
+  std::uint64_t len = varint();
+  return std::string(bytes(len), static_cast<std::size_t>(len));
+}
+
+void ByteReader::skip(std::uint64_t count)
+{
+  bytes(count);
+}
+
+const char* ByteReader::bytes(std::uint64_t count)
+{
+  if (count > remaining())
+    throw std::runtime_error("ByteReader::bytes: unexpected end of data");
+  const char* result = m_pos;
+  m_pos += count;
+  return result;
+}
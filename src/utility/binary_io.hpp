@@ -0,0 +1,70 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_BINARY_IO_HPP
+#define NONNY_BINARY_IO_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+/*
+ * Helpers for the binary file formats. Integers are written as
+ * unsigned LEB128 varints, strings as a varint length followed by the
+ * raw bytes.
+ */
+
+// Append an encoded value to a byte buffer
+std::string& put_varint(std::string& buf, std::uint64_t value);
+std::string& put_string(std::string& buf, const std::string& str);
+
+// Append a fixed-width little-endian value to a byte buffer
+std::string& put_uint64(std::string& buf, std::uint64_t value);
+
+// Read a varint directly from a stream, throws runtime_error on failure
+std::uint64_t read_varint(std::istream& is);
+
+/*
+ * Decodes values from an in-memory buffer. Throws std::runtime_error if
+ * the data ends prematurely.
+ */
+class ByteReader {
+public:
+  ByteReader(const char* begin, const char* end) : m_pos(begin), m_end(end) { }
+  explicit ByteReader(const std::string& buf)
+    : m_pos(buf.data()), m_end(buf.data() + buf.size()) { }
+
+  unsigned char byte();
+  std::uint64_t varint();
+  std::uint64_t uint64();
+  std::string string();
+  void skip(std::uint64_t count);
+
+  // Return a pointer to the next count bytes and advance past them
+  const char* bytes(std::uint64_t count);
+
+  std::uint64_t remaining() const { return m_end - m_pos; }
+  bool at_end() const { return m_pos == m_end; }
+private:
+  const char* m_pos;
+  const char* m_end;
+};
+
+#endif
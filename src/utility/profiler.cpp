@@ -0,0 +1,138 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "utility/profiler.hpp"
+
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+thread_local bool Profiler::s_frame_thread = false;
+
+Profiler& Profiler::instance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::set_enabled(bool enabled)
+{
+  if (enabled && !m_enabled) {
+    m_frames.clear();
+    m_next_frame = 0;
+  }
+  m_enabled = enabled;
+}
+
+void Profiler::begin_frame()
+{
+  if (!m_enabled)
+    return;
+
+  s_frame_thread = true;
+  m_in_frame = true;
+  m_cur_frame = Frame();
+  m_depth.fill(0);
+  m_frame_start = Clock::now();
+}
+
+void Profiler::end_frame()
+{
+  if (!m_in_frame)
+    return;
+  m_in_frame = false;
+
+  auto elapsed = Clock::now() - m_frame_start;
+  m_cur_frame.time = static_cast<unsigned>
+    (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+  if (m_frames.size() < max_frames)
+    m_frames.push_back(m_cur_frame);
+  else {
+    m_frames[m_next_frame] = m_cur_frame;
+    m_next_frame = (m_next_frame + 1) % max_frames;
+  }
+}
+
+void Profiler::leave_section(Section section, unsigned time)
+{
+  int index = static_cast<int>(section);
+  if (m_depth[index] > 0 && --m_depth[index] == 0) {
+    m_cur_frame.section_time[index] += time;
+    ++m_cur_frame.calls[index];
+  }
+}
+
+const Profiler::Frame& Profiler::frame(std::size_t index) const
+{
+  if (index >= m_frames.size())
+    throw std::out_of_range("Profiler::frame: invalid frame index");
+
+  return m_frames[(m_next_frame + index) % m_frames.size()];
+}
+
+const char* Profiler::section_name(Section section)
+{
+  switch (section) {
+  case Section::view_update:
+    return "view_update";
+  case Section::view_draw:
+    return "view_draw";
+  case Section::puzzle_update:
+    return "puzzle_update";
+  case Section::puzzle_cells:
+    return "puzzle_cells";
+  case Section::puzzle_clues:
+    return "puzzle_clues";
+  case Section::render:
+    return "render";
+  case Section::present:
+    return "present";
+  default:
+    return "";
+  }
+}
+
+void Profiler::write(std::ostream& os) const
+{
+  os << "frame,frame_us";
+  for (int i = 0; i < num_sections; ++i) {
+    const char* name = section_name(static_cast<Section>(i));
+    os << "," << name << "_us," << name << "_calls";
+  }
+  os << "\n";
+
+  for (std::size_t f = 0; f < num_frames(); ++f) {
+    const Frame& fr = frame(f);
+    os << f << "," << fr.time;
+    for (int i = 0; i < num_sections; ++i)
+      os << "," << fr.section_time[i] << "," << fr.calls[i];
+    os << "\n";
+  }
+}
+
+void Profiler::write_file(const std::string& filename) const
+{
+  std::ofstream file(filename);
+  if (!file.is_open())
+    throw std::runtime_error("Profiler::write_file: could not open file "
+                             + filename);
+  write(file);
+}
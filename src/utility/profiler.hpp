@@ -0,0 +1,145 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_PROFILER_HPP
+#define NONNY_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/*
+ * Collects per-frame timings for the main subsystems. The game loop
+ * calls begin_frame and end_frame, and code of interest is wrapped in
+ * a ScopedTimer. Nothing is recorded unless profiling is enabled, and
+ * only the thread that began the frame is timed, so background work
+ * does not skew the numbers. The most recent frames are kept in a
+ * ring buffer.
+ *
+ * Section times are inclusive: time spent drawing the puzzle is also
+ * counted as view drawing, for example. A section nested within
+ * itself is only counted once.
+ */
+class Profiler {
+public:
+  enum class Section {
+    view_update, view_draw, puzzle_update, puzzle_cells, puzzle_clues,
+    render, present
+  };
+  static constexpr int num_sections = 7;
+  static constexpr std::size_t max_frames = 300;
+
+  // Times are in microseconds
+  struct Frame {
+    unsigned time = 0;
+    std::array<unsigned, num_sections> section_time {};
+    std::array<unsigned, num_sections> calls {};
+  };
+
+  static Profiler& instance();
+
+  void set_enabled(bool enabled);
+  bool is_enabled() const { return m_enabled; }
+
+  void begin_frame();
+  void end_frame();
+
+  // Called by ScopedTimer; returns false if nothing is being timed
+  inline bool enter_section(Section section);
+  void leave_section(Section section, unsigned time);
+
+  // Recorded frames, oldest first
+  std::size_t num_frames() const { return m_frames.size(); }
+  const Frame& frame(std::size_t index) const;
+
+  static const char* section_name(Section section);
+
+  // Write the recorded frames as comma-separated values
+  void write(std::ostream& os) const;
+  void write_file(const std::string& filename) const;
+
+private:
+  Profiler() = default;
+
+  typedef std::chrono::steady_clock Clock;
+
+  static thread_local bool s_frame_thread;
+
+  std::atomic<bool> m_enabled {false};
+  bool m_in_frame = false; //only accessed from the frame thread
+  std::array<int, num_sections> m_depth {};
+  Clock::time_point m_frame_start;
+  Frame m_cur_frame;
+  std::vector<Frame> m_frames;
+  std::size_t m_next_frame = 0; //oldest frame once the buffer is full
+};
+
+/*
+ * Adds the time between construction and destruction to a section of
+ * the current frame.
+ */
+class ScopedTimer {
+public:
+  explicit inline ScopedTimer(Profiler::Section section);
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  inline ~ScopedTimer();
+
+private:
+  Profiler::Section m_section;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+
+/* implementation */
+
+inline bool Profiler::enter_section(Section section)
+{
+  if (!s_frame_thread || !m_in_frame || !m_enabled)
+    return false;
+
+  ++m_depth[static_cast<int>(section)];
+  return true;
+}
+
+inline ScopedTimer::ScopedTimer(Profiler::Section section)
+  : m_section(section),
+    m_active(Profiler::instance().enter_section(section))
+{
+  if (m_active)
+    m_start = std::chrono::steady_clock::now();
+}
+
+inline ScopedTimer::~ScopedTimer()
+{
+  if (m_active) {
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    Profiler::instance().leave_section(m_section,
+                                       static_cast<unsigned>(us.count()));
+  }
+}
+
+#endif
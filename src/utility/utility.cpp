@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <sstream>
 #include <stdexcept>
+#include <system_error>
 #include <experimental/filesystem>
 #include "config.h"
 
@@ -37,7 +38,7 @@ std::string base_path()
 #ifdef NONNY_INPUT_SDL
   std::string result = sdl_base_path();
 #else
-  throw std::runtime_error("::base_path: base path not retrievable");
+  std::string result = stdfs::current_path().string();
 #endif
 
   stdfs::path p(result);
@@ -50,16 +51,27 @@ std::string base_path()
 std::string save_path()
 {
 #ifdef NONNY_INPUT_SDL
-  std::string result = sdl_save_path();
-#else
-  throw std::runtime_error("::save_path: save path not retrievable");
-#endif
-
-  stdfs::path p(result);
+  stdfs::path p(sdl_save_path());
   if (!stdfs::exists(p))
     stdfs::create_directories(p);
 
   return stdfs::canonical(p).string();
+#else
+  throw std::runtime_error("::save_path: save path not retrievable");
+#endif
+}
+
+void replace_file(const std::string& source, const std::string& target)
+{
+  std::error_code ec;
+  stdfs::rename(source, target, ec);
+  if (ec && stdfs::exists(target)) {
+    stdfs::remove(target);
+    stdfs::rename(source, target);
+  } else if (ec) {
+    throw stdfs::filesystem_error("::replace_file: could not rename file",
+                                  source, target, ec);
+  }
 }
 
 char escape(char c)
@@ -34,6 +34,12 @@ std::string base_path();
 // Returns the default directory where save data should go
 std::string save_path();
 
+/*
+ * Moves the file source over target. Where the platform refuses to
+ * rename onto an existing file, target is removed first.
+ */
+void replace_file(const std::string& source, const std::string& target);
+
 // Converts an escape sequence code to its corresponding character
 char escape(char c);
 
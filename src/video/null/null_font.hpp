@@ -0,0 +1,53 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_NULL_FONT_HPP
+#define NONNY_NULL_FONT_HPP
+
+#include "video/font.hpp"
+
+/*
+ * A font that loads nothing. Text is measured as if every character
+ * were half as wide as the point size.
+ */
+class NullFont : public Font {
+public:
+  explicit NullFont(int pt_size) : m_pt_size(pt_size) { }
+
+  inline void text_size(const std::string& text,
+                        int* width, int* height) const override;
+  void resize(int pt_size) override { m_pt_size = pt_size; }
+private:
+  int m_pt_size;
+};
+
+
+/* implementation */
+
+inline void NullFont::text_size(const std::string& text,
+                                int* width, int* height) const
+{
+  if (width)
+    *width = static_cast<int>(text.size()) * m_pt_size / 2;
+  if (height)
+    *height = m_pt_size * 6 / 5;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "video/null/null_renderer.hpp"
+
+#include "video/font.hpp"
+#include "video/null/null_texture.hpp"
+#include "video/point.hpp"
+#include "video/rect.hpp"
+
+void NullRenderer::count_draw(unsigned long primitives)
+{
+  ++m_stats.draw_calls;
+  m_stats.primitives += primitives;
+}
+
+void NullRenderer::draw_line(const Point& point1, const Point& point2)
+{
+  count_draw();
+}
+
+void NullRenderer::draw_lines(const std::vector<Point>& endpoints)
+{
+  if (endpoints.size() >= 2)
+    count_draw(endpoints.size() / 2);
+}
+
+void NullRenderer::draw_dotted_line(const Point& start,
+                                    int length, bool vertical)
+{
+  count_draw(length / 3 + 1);
+}
+
+void NullRenderer::fill_rects(const std::vector<Rect>& rects)
+{
+  if (!rects.empty())
+    count_draw(rects.size());
+}
+
+Rect NullRenderer::draw_text(const Point& point, const Font& font,
+                             const std::string& text)
+{
+  int width = 0, height = 0;
+  font.text_size(text, &width, &height);
+  count_draw();
+  ++m_stats.text_draws;
+  return Rect(point.x(), point.y(), width, height);
+}
+
+Rect NullRenderer::draw_text_with_bg(const Point& point, const Font& font,
+                                     const std::string& text,
+                                     const Color& bg_color)
+{
+  count_draw();
+  return draw_text(point, font, text);
+}
+
+void NullRenderer::copy_texture(const Texture& src,
+                                const Rect& src_rect, const Rect& dest_rect)
+{
+  count_draw();
+  ++m_stats.texture_copies;
+}
+
+void NullRenderer::copy_texture(const Texture& src, const Rect& src_rect,
+                                const std::vector<Rect>& dest_rects)
+{
+  if (!dest_rects.empty()) {
+    count_draw(dest_rects.size());
+    m_stats.texture_copies += dest_rects.size();
+  }
+}
+
+std::unique_ptr<Texture> NullRenderer::new_target_texture(int width,
+                                                          int height)
+{
+  ++m_stats.textures_created;
+  return std::make_unique<NullTexture>(width, height);
+}
+
+std::unique_ptr<Texture> NullRenderer::new_streaming_texture(int width,
+                                                             int height)
+{
+  ++m_stats.textures_created;
+  return std::make_unique<NullTexture>(width, height);
+}
+
+void NullRenderer::update_texture(Texture& texture, const Rect& rect,
+                                  const std::uint32_t* pixels)
+{
+  m_stats.bytes_uploaded += static_cast<unsigned long>(rect.width())
+    * rect.height() * sizeof(std::uint32_t);
+}
+
+void NullRenderer::set_target(Texture& texture, bool clear)
+{
+  ++m_stats.target_changes;
+  if (clear)
+    count_draw();
+}
@@ -0,0 +1,102 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_NULL_RENDERER_HPP
+#define NONNY_NULL_RENDERER_HPP
+
+#include "video/renderer.hpp"
+
+/*
+ * A renderer that draws nothing but counts what it is asked to do,
+ * so that interface code can be run and measured without a display.
+ * Batched calls count as one draw call but add each of their
+ * primitives.
+ */
+class NullRenderer : public Renderer {
+public:
+  struct Stats {
+    unsigned long draw_calls = 0;
+    unsigned long primitives = 0;
+    unsigned long text_draws = 0;
+    unsigned long texture_copies = 0;
+    unsigned long textures_created = 0;
+    unsigned long bytes_uploaded = 0;
+    unsigned long target_changes = 0;
+    unsigned long presents = 0;
+  };
+
+  NullRenderer() { }
+
+  NullRenderer(const NullRenderer&) = delete;
+  NullRenderer& operator=(const NullRenderer&) = delete;
+
+  const Stats& stats() const { return m_stats; }
+  void reset_stats() { m_stats = Stats(); }
+
+  void present() override { ++m_stats.presents; }
+
+  void clear() override { count_draw(); }
+  void draw_point(const Point& point) override { count_draw(); }
+
+  void draw_line(const Point& point1, const Point& point2) override;
+  void draw_lines(const std::vector<Point>& endpoints) override;
+  void draw_dotted_line(const Point& start,
+                        int length, bool vertical = true) override;
+
+  void draw_rect(const Rect& rect) override { count_draw(); }
+  void fill_rect(const Rect& rect) override { count_draw(); }
+  void fill_rects(const std::vector<Rect>& rects) override;
+
+  Rect draw_text(const Point& point, const Font& font,
+                 const std::string& text) override;
+  Rect draw_text_with_bg(const Point& point, const Font& font,
+                         const std::string& text,
+                         const Color& bg_color) override;
+
+  void copy_texture(const Texture& src,
+                    const Rect& src_rect,
+                    const Rect& dest_rect) override;
+  void copy_texture(const Texture& src,
+                    const Rect& src_rect,
+                    const std::vector<Rect>& dest_rects) override;
+
+  std::unique_ptr<Texture> new_target_texture(int width,
+                                              int height) override;
+  std::unique_ptr<Texture> new_streaming_texture(int width,
+                                                 int height) override;
+  void update_texture(Texture& texture, const Rect& rect,
+                      const std::uint32_t* pixels) override;
+
+  void set_target(Texture& texture, bool clear = false) override;
+  void set_target() override { ++m_stats.target_changes; }
+
+  void set_draw_color(const Color& color) override { }
+  void set_clip_rect() override { }
+  void set_clip_rect(const Rect& rect) override { }
+  void set_viewport() override { }
+  void set_viewport(const Rect& rect) override { }
+
+private:
+  void count_draw(unsigned long primitives = 1);
+
+  Stats m_stats;
+};
+
+#endif
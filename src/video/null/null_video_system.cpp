@@ -0,0 +1,68 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "video/null/null_video_system.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include "video/null/null_font.hpp"
+#include "video/null/null_renderer.hpp"
+#include "video/null/null_texture.hpp"
+#include "video/null/null_window.hpp"
+
+std::unique_ptr<Window>
+NullVideoSystem::new_window(const WindowSettings& ws) const
+{
+  return std::make_unique<NullWindow>(ws);
+}
+
+std::unique_ptr<Renderer> NullVideoSystem::new_renderer(Window& window) const
+{
+  return std::make_unique<NullRenderer>();
+}
+
+std::unique_ptr<Font> NullVideoSystem::new_font(const std::string& filename,
+                                                int pt_size) const
+{
+  return std::make_unique<NullFont>(pt_size);
+}
+
+std::unique_ptr<Texture>
+NullVideoSystem::load_image(Renderer& renderer,
+                            const std::string& filename) const
+{
+  //the width and height are big-endian values in the IHDR chunk,
+  //which always follows the 8-byte signature
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+  unsigned char header[24];
+  if (!file.read(reinterpret_cast<char*>(header), sizeof(header))
+      || header[1] != 'P' || header[2] != 'N' || header[3] != 'G')
+    throw std::runtime_error("NullVideoSystem::load_image: "
+                             "could not read PNG file " + filename);
+
+  auto read_u32 = [&header](int pos) {
+    return static_cast<int>(std::uint32_t(header[pos]) << 24
+                            | std::uint32_t(header[pos + 1]) << 16
+                            | std::uint32_t(header[pos + 2]) << 8
+                            | std::uint32_t(header[pos + 3]));
+  };
+  return std::make_unique<NullTexture>(read_u32(16), read_u32(20));
+}
@@ -0,0 +1,49 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_NULL_VIDEO_SYSTEM_HPP
+#define NONNY_NULL_VIDEO_SYSTEM_HPP
+
+#include <memory>
+#include <string>
+#include "video/video_system.hpp"
+
+/*
+ * Video system that opens no window and draws nothing, for running
+ * the interface offscreen. Renderers are NullRenderers.
+ */
+class NullVideoSystem : public VideoSystem {
+public:
+  NullVideoSystem() { }
+
+  NullVideoSystem(const NullVideoSystem&) = delete;
+  NullVideoSystem& operator=(const NullVideoSystem&) = delete;
+
+  std::unique_ptr<Window> new_window(const WindowSettings& ws) const override;
+  std::unique_ptr<Renderer> new_renderer(Window& window) const override;
+  std::unique_ptr<Font> new_font(const std::string& filename,
+                                 int pt_size = 12) const override;
+
+  // Only the image dimensions are read, which requires a PNG file
+  std::unique_ptr<Texture>
+  load_image(Renderer& renderer, const std::string& filename) const override;
+};
+
+#endif
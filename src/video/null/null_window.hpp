@@ -0,0 +1,38 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_NULL_WINDOW_HPP
+#define NONNY_NULL_WINDOW_HPP
+
+#include "video/window.hpp"
+
+// An offscreen window that only has a size
+class NullWindow : public Window {
+public:
+  explicit NullWindow(const WindowSettings& ws)
+    : m_width(ws.width), m_height(ws.height) { }
+
+  int width() const override { return m_width; }
+  int height() const override { return m_height; }
+private:
+  int m_width, m_height;
+};
+
+#endif
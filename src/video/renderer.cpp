@@ -23,8 +23,28 @@
 #include <algorithm>
 #include <cstddef>
 #include "video/font.hpp"
+#include "video/point.hpp"
 #include "video/rect.hpp"
 
+void Renderer::draw_lines(const std::vector<Point>& endpoints)
+{
+  for (std::size_t i = 0; i + 1 < endpoints.size(); i += 2)
+    draw_line(endpoints[i], endpoints[i + 1]);
+}
+
+void Renderer::fill_rects(const std::vector<Rect>& rects)
+{
+  for (const auto& rect : rects)
+    fill_rect(rect);
+}
+
+void Renderer::copy_texture(const Texture& src, const Rect& src_rect,
+                            const std::vector<Rect>& dest_rects)
+{
+  for (const auto& dest_rect : dest_rects)
+    copy_texture(src, src_rect, dest_rect);
+}
+
 void Renderer::draw_thick_line(const Point& start,
                                  int length, int thickness, bool vertical)
 {
@@ -21,7 +21,10 @@
 #ifndef NONNY_RENDERER_HPP
 #define NONNY_RENDERER_HPP
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include "color/color.hpp"
 
 class Font;
@@ -44,6 +47,9 @@ public:
   virtual void draw_point(const Point& point) = 0;
 
   virtual void draw_line(const Point& point1, const Point& point2) = 0;
+  //draw a line segment between each pair of consecutive endpoints
+  //(the first and second, the third and fourth, and so on)
+  virtual void draw_lines(const std::vector<Point>& endpoints);
   virtual void draw_thick_line(const Point& start,
                                int length, int thickness,
                                bool vertical = true);
@@ -54,6 +60,7 @@ public:
   virtual void draw_thick_rect(const Rect& rect, int thickness);
   virtual void draw_dotted_rect(const Rect& rect);
   virtual void fill_rect(const Rect& rect) = 0;
+  virtual void fill_rects(const std::vector<Rect>& rects);
 
   virtual Rect draw_text(const Point& point, const Font& font,
                          const std::string& text) = 0;
@@ -67,12 +74,49 @@ public:
   virtual void copy_texture(const Texture& src,
                             const Rect& src_rect,
                             const Rect& dest_rect) = 0;
+  //copy the same region of the texture to every destination
+  virtual void copy_texture(const Texture& src,
+                            const Rect& src_rect,
+                            const std::vector<Rect>& dest_rects);
+
+  /*
+   * Create a texture that can be drawn onto with set_target. Returns
+   * nullptr if the renderer cannot draw to textures.
+   */
+  virtual std::unique_ptr<Texture> new_target_texture(int width,
+                                                      int height) = 0;
+
+  /*
+   * Create a texture whose pixels are set directly with
+   * update_texture. Returns nullptr if this is not possible.
+   */
+  virtual std::unique_ptr<Texture> new_streaming_texture(int width,
+                                                         int height) = 0;
+
+  //replace the pixels in rect, given row by row as 0xRRGGBBAA values
+  virtual void update_texture(Texture& texture, const Rect& rect,
+                              const std::uint32_t* pixels) = 0;
+
+  //redirect drawing to a texture from new_target_texture, optionally
+  //clearing it to transparent first; set_target() restores drawing
+  //to the window
+  virtual void set_target(Texture& texture, bool clear = false) = 0;
+  virtual void set_target() = 0;
 
   virtual void set_draw_color(const Color& color) = 0;
   virtual void set_clip_rect() = 0;
   virtual void set_clip_rect(const Rect& rect) = 0;
   virtual void set_viewport() = 0;
   virtual void set_viewport(const Rect& rect) = 0;
+
+  //The contents of target textures can be lost, for example when the
+  //graphics device is reset. The event handler reports this here, and
+  //anything keeping textures drawn earlier compares the generation.
+  void targets_reset() { ++m_target_generation; }
+  unsigned long target_generation() const { return m_target_generation; }
+
+private:
+  unsigned long m_target_generation = 0;
 };
 
 #endif
@@ -37,6 +37,18 @@ SDLFont::~SDLFont()
 void SDLFont::text_size(const std::string& text,
                         int* width, int* height) const
 {
+  //clue numbers are measured constantly, use the cached digit widths
+  if (is_digit_string(text)) {
+    if (width) {
+      *width = 0;
+      for (char c : text)
+        *width += digit_width(c);
+    }
+    if (height)
+      *height = m_height;
+    return;
+  }
+
   int wd = 0, ht = 0;
   if (TTF_SizeUTF8(m_font, text.c_str(), &wd, &ht) == 0) {
     if (width)
@@ -48,6 +60,10 @@ void SDLFont::text_size(const std::string& text,
 
 void SDLFont::resize(int pt_size)
 {
+  //reopening would needlessly invalidate everything cached for the font
+  if (m_font && pt_size == m_pt_size)
+    return;
+
   if (m_font)
     TTF_CloseFont(m_font);
   m_pt_size = pt_size;
@@ -56,4 +72,15 @@ void SDLFont::resize(int pt_size)
   if (!m_font)
     throw std::runtime_error("SDLFont::resize: Could not open font "
                              + m_filename);
+
+  static unsigned long next_cache_id = 0;
+  m_cache_id = ++next_cache_id;
+
+  m_height = TTF_FontHeight(m_font);
+  for (int i = 0; i < 10; ++i) {
+    char digit[] = { static_cast<char>('0' + i), '\0' };
+    int wd = 0, ht = 0;
+    TTF_SizeUTF8(m_font, digit, &wd, &ht);
+    m_digit_width[i] = wd;
+  }
 }
@@ -21,6 +21,7 @@
 #ifndef NONNY_SDL_FONT_HPP
 #define NONNY_SDL_FONT_HPP
 
+#include <array>
 #include <string>
 #include "SDL_ttf.h"
 #include "video/font.hpp"
@@ -36,10 +37,38 @@ public:
 
   TTF_Font* get_sdl_handle() const { return m_font; }
 
+  //identifies the current face and size, changes whenever the font
+  //is reopened so that cached renderings can be told apart
+  unsigned long cache_id() const { return m_cache_id; }
+
+  int height() const { return m_height; }
+  int digit_width(char digit) const { return m_digit_width[digit - '0']; }
+
 private:
   TTF_Font* m_font = nullptr;
   std::string m_filename;
   int m_pt_size;
+
+  unsigned long m_cache_id = 0;
+  int m_height = 0;
+  std::array<int, 10> m_digit_width;
 };
 
+//returns true if the nonempty string text consists only of the
+//digits 0-9
+inline bool is_digit_string(const std::string& text);
+
+
+/* implementation */
+
+inline bool is_digit_string(const std::string& text)
+{
+  if (text.empty())
+    return false;
+  for (char c : text)
+    if (c < '0' || c > '9')
+      return false;
+  return true;
+}
+
 #endif
@@ -20,10 +20,14 @@
 
 #include "video/sdl/sdl_renderer.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
+#include "utility/profiler.hpp"
 #include "utility/sdl/sdl_error.hpp"
 #include "utility/utility.hpp"
 #include "video/sdl/sdl_font.hpp"
+#include "video/sdl/sdl_text_cache.hpp"
 #include "video/sdl/sdl_texture.hpp"
 #include "video/sdl/sdl_window.hpp"
 #include "video/point.hpp"
@@ -43,27 +47,64 @@ SDLRenderer::SDLRenderer(Window& window)
                                   | SDL_RENDERER_PRESENTVSYNC);
   if (!m_renderer)
     throw SDLError("SDL_CreateRenderer");
+
+  m_text_cache.reset(new SDLTextCache(m_renderer));
 }
 
 SDLRenderer::~SDLRenderer()
 {
+  //cached textures must go before the renderer that owns them
+  m_text_cache.reset();
   SDL_DestroyRenderer(m_renderer);
 }
 
+void SDLRenderer::present()
+{
+  ScopedTimer timer(Profiler::Section::present);
+  SDL_RenderPresent(m_renderer);
+}
+
 void SDLRenderer::draw_point(const Point& point)
 {
+  ScopedTimer timer(Profiler::Section::render);
   SDL_RenderDrawPoint(m_renderer, point.x(), point.y());
 }
 
 void SDLRenderer::draw_line(const Point& point1, const Point& point2)
 {
+  ScopedTimer timer(Profiler::Section::render);
   SDL_RenderDrawLine(m_renderer, point1.x(), point1.y(),
                      point2.x(), point2.y());
 }
 
+void SDLRenderer::draw_lines(const std::vector<Point>& endpoints)
+{
+  ScopedTimer timer(Profiler::Section::render);
+  //axis-aligned segments, which is nearly all of them, are submitted
+  //together as one-pixel-wide rectangles
+  std::vector<SDL_Rect> rects;
+  rects.reserve(endpoints.size() / 2);
+  for (std::size_t i = 0; i + 1 < endpoints.size(); i += 2) {
+    const Point& p1 = endpoints[i];
+    const Point& p2 = endpoints[i + 1];
+    if (p1.x() == p2.x())
+      rects.push_back(SDL_Rect { p1.x(), std::min(p1.y(), p2.y()),
+                                 1, std::abs(p2.y() - p1.y()) + 1 });
+    else if (p1.y() == p2.y())
+      rects.push_back(SDL_Rect { std::min(p1.x(), p2.x()), p1.y(),
+                                 std::abs(p2.x() - p1.x()) + 1, 1 });
+    else
+      draw_line(p1, p2);
+  }
+
+  if (!rects.empty())
+    SDL_RenderFillRects(m_renderer, rects.data(), rects.size());
+}
+
 void SDLRenderer::draw_dotted_line(const Point& start,
                                    int length, bool vertical)
 {
+  ScopedTimer timer(Profiler::Section::render);
   std::vector<SDL_Point> points;
   for (int n = 0; n <= length; n += 3) {
     if (vertical)
@@ -77,16 +118,31 @@ void SDLRenderer::draw_dotted_line(const Point& start,
 
 void SDLRenderer::draw_rect(const Rect& rect)
 {
+  ScopedTimer timer(Profiler::Section::render);
   SDL_Rect srect = rect_to_sdl_rect(rect);
   SDL_RenderDrawRect(m_renderer, &srect);
 }
 
 void SDLRenderer::fill_rect(const Rect& rect)
 {
+  ScopedTimer timer(Profiler::Section::render);
   SDL_Rect srect = rect_to_sdl_rect(rect);
   SDL_RenderFillRect(m_renderer, &srect);
 }
 
+void SDLRenderer::fill_rects(const std::vector<Rect>& rects)
+{
+  ScopedTimer timer(Profiler::Section::render);
+  if (rects.empty())
+    return;
+
+  std::vector<SDL_Rect> srects;
+  srects.reserve(rects.size());
+  for (const auto& rect : rects)
+    srects.push_back(rect_to_sdl_rect(rect));
+  SDL_RenderFillRects(m_renderer, srects.data(), srects.size());
+}
+
 void SDLRenderer::set_draw_color(const Color& color)
 {
   m_draw_color.r = color.red();
@@ -101,19 +157,37 @@ void SDLRenderer::set_draw_color(const Color& color)
 Rect SDLRenderer::draw_text(const Point& point, const Font& font,
                             const std::string& text)
 {
-  const SDLFont* sdl_font = dynamic_cast<const SDLFont*>(&font);
-  if (!sdl_font)
-    throw std::runtime_error("SDLRenderer::draw_text: "
-                             "given Font is not an SDLFont");
-  SDL_Surface* surface
-    = TTF_RenderUTF8_Blended(sdl_font->get_sdl_handle(),
-                             text.c_str(),
-                             m_draw_color);
-  SDLTexture texture(m_renderer, surface);
-  SDL_FreeSurface(surface);
-
-  Rect dest_rect(point.x(), point.y(), texture.width(), texture.height());
-  copy_texture(texture, Rect(), dest_rect);
+  ScopedTimer timer(Profiler::Section::render);
+  const SDLFont& sfont = sdl_font(font);
+
+  if (is_digit_string(text)) {
+    const SDLTextCache::GlyphAtlas& atlas = m_text_cache->digit_atlas(sfont);
+    SDL_Texture* texture = atlas.texture->get_sdl_handle();
+    SDL_SetTextureColorMod(texture,
+                           m_draw_color.r, m_draw_color.g, m_draw_color.b);
+
+    SDL_Rect dest { point.x(), point.y(), 0, 0 };
+    int width = 0, height = 0;
+    for (char c : text) {
+      const SDL_Rect& glyph = atlas.digits[c - '0'];
+      dest.w = glyph.w;
+      dest.h = glyph.h;
+      SDL_RenderCopy(m_renderer, texture, &glyph, &dest);
+      dest.x += glyph.w;
+      width += glyph.w;
+      height = std::max(height, glyph.h);
+    }
+    return Rect(point.x(), point.y(), width, height);
+  }
+
+  const SDLTexture* texture = m_text_cache->string_texture(sfont, text);
+  if (!texture)
+    return Rect(point.x(), point.y(), 0, 0);
+
+  SDL_SetTextureColorMod(texture->get_sdl_handle(),
+                         m_draw_color.r, m_draw_color.g, m_draw_color.b);
+  Rect dest_rect(point.x(), point.y(), texture->width(), texture->height());
+  copy_texture(*texture, Rect(), dest_rect);
   return dest_rect;
 }
 
@@ -121,39 +195,119 @@ Rect SDLRenderer::draw_text_with_bg(const Point& point, const Font& font,
                                     const std::string& text,
                                     const Color& bg_color)
 {
-  const SDLFont* sdl_font = dynamic_cast<const SDLFont*>(&font);
-  if (!sdl_font)
-    throw std::runtime_error("SDLRenderer::draw_text: "
-                             "given Font is not an SDLFont");
+  ScopedTimer timer(Profiler::Section::render);
+  int width = 0, height = 0;
+  sdl_font(font).text_size(text, &width, &height);
 
-  SDL_Color bg = { static_cast<Uint8>(bg_color.red()),
-                   static_cast<Uint8>(bg_color.green()),
-                   static_cast<Uint8>(bg_color.blue()) };
-  SDL_Surface* surface
-    = TTF_RenderUTF8_Shaded(sdl_font->get_sdl_handle(),
-                            text.c_str(),
-                            m_draw_color, bg);
-  SDLTexture texture(m_renderer, surface);
-  SDL_FreeSurface(surface);
-
-  Rect dest_rect(point.x(), point.y(), texture.width(), texture.height());
-  copy_texture(texture, Rect(), dest_rect);
-  return dest_rect;
+  SDL_SetRenderDrawColor(m_renderer,
+                         bg_color.red(), bg_color.green(), bg_color.blue(),
+                         255);
+  SDL_Rect bg_rect { point.x(), point.y(), width, height };
+  SDL_RenderFillRect(m_renderer, &bg_rect);
+  SDL_SetRenderDrawColor(m_renderer,
+                         m_draw_color.r, m_draw_color.g, m_draw_color.b,
+                         255);
+
+  return draw_text(point, font, text);
 }
 
 void SDLRenderer::copy_texture(const Texture& src,
                                const Rect& src_rect, const Rect& dest_rect)
 {
-  const SDLTexture* texture = dynamic_cast<const SDLTexture*>(&src);
-  if (!texture)
-    throw std::runtime_error("SDLRenderer::copy: "
-                             "given Texture is not an SDLTexture");
-
+  ScopedTimer timer(Profiler::Section::render);
   SDL_Rect sr = rect_to_sdl_rect(src_rect);
   SDL_Rect dr = rect_to_sdl_rect(dest_rect);
   SDL_Rect* p_sr = src_rect ? &sr : NULL;
   SDL_Rect* p_dr = dest_rect ? &dr : NULL;
-  SDL_RenderCopy(m_renderer, texture->get_sdl_handle(), p_sr, p_dr);
+  SDL_RenderCopy(m_renderer, sdl_texture(src).get_sdl_handle(), p_sr, p_dr);
+}
+
+void SDLRenderer::copy_texture(const Texture& src, const Rect& src_rect,
+                               const std::vector<Rect>& dest_rects)
+{
+  ScopedTimer timer(Profiler::Section::render);
+  SDL_Texture* texture = sdl_texture(src).get_sdl_handle();
+  SDL_Rect sr = rect_to_sdl_rect(src_rect);
+  SDL_Rect* p_sr = src_rect ? &sr : NULL;
+  for (const auto& dest_rect : dest_rects) {
+    SDL_Rect dr = rect_to_sdl_rect(dest_rect);
+    SDL_RenderCopy(m_renderer, texture, p_sr, dest_rect ? &dr : NULL);
+  }
+}
+
+std::unique_ptr<Texture> SDLRenderer::new_target_texture(int width,
+                                                         int height)
+{
+  if (!SDL_RenderTargetSupported(m_renderer) || width <= 0 || height <= 0)
+    return nullptr;
+
+  std::unique_ptr<SDLTexture> texture(new SDLTexture(m_renderer,
+                                                     width, height));
+  if (!texture->get_sdl_handle())
+    return nullptr;
+
+  SDL_SetTextureBlendMode(texture->get_sdl_handle(), SDL_BLENDMODE_BLEND);
+  return std::move(texture);
+}
+
+std::unique_ptr<Texture> SDLRenderer::new_streaming_texture(int width,
+                                                            int height)
+{
+  if (width <= 0 || height <= 0)
+    return nullptr;
+
+  std::unique_ptr<SDLTexture> texture(
+    new SDLTexture(m_renderer, width, height, SDL_TEXTUREACCESS_STREAMING));
+  if (!texture->get_sdl_handle())
+    return nullptr;
+
+  return std::move(texture);
+}
+
+void SDLRenderer::update_texture(Texture& texture, const Rect& rect,
+                                 const std::uint32_t* pixels)
+{
+  ScopedTimer timer(Profiler::Section::render);
+  //SDL_PIXELFORMAT_RGBA8888 is a packed format, so 0xRRGGBBAA values
+  //can be passed through unchanged
+  SDL_Rect srect = rect_to_sdl_rect(rect);
+  SDL_UpdateTexture(sdl_texture(texture).get_sdl_handle(), &srect,
+                    pixels, rect.width() * sizeof(std::uint32_t));
+}
+
+void SDLRenderer::set_target(Texture& texture, bool clear)
+{
+  SDL_SetRenderTarget(m_renderer, sdl_texture(texture).get_sdl_handle());
+
+  if (clear) {
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+    SDL_RenderClear(m_renderer);
+    SDL_SetRenderDrawColor(m_renderer, m_draw_color.r, m_draw_color.g,
+                           m_draw_color.b, 255);
+  }
+}
+
+void SDLRenderer::set_target()
+{
+  SDL_SetRenderTarget(m_renderer, NULL);
+}
+
+const SDLFont& SDLRenderer::sdl_font(const Font& font) const
+{
+  const SDLFont* sdl_font = dynamic_cast<const SDLFont*>(&font);
+  if (!sdl_font)
+    throw std::runtime_error("SDLRenderer::draw_text: "
+                             "given Font is not an SDLFont");
+  return *sdl_font;
+}
+
+const SDLTexture& SDLRenderer::sdl_texture(const Texture& texture) const
+{
+  const SDLTexture* sdl_texture = dynamic_cast<const SDLTexture*>(&texture);
+  if (!sdl_texture)
+    throw std::runtime_error("SDLRenderer::copy: "
+                             "given Texture is not an SDLTexture");
+  return *sdl_texture;
 }
 
 void SDLRenderer::set_clip_rect()
@@ -21,11 +21,17 @@
 #ifndef NONNY_SDL_RENDERER_HPP
 #define NONNY_SDL_RENDERER_HPP
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include "SDL.h"
 #include "video/renderer.hpp"
 
 class Font;
+class SDLFont;
+class SDLTextCache;
+class SDLTexture;
 class Point;
 class Rect;
 class Window;
@@ -35,7 +41,7 @@ public:
   SDLRenderer(Window& window);
   ~SDLRenderer();
 
-  void present() override { SDL_RenderPresent(m_renderer); }
+  void present() override;
 
   void set_draw_color(const Color& color) override;
 
@@ -43,11 +49,13 @@ public:
   void draw_point(const Point& point) override;
 
   void draw_line(const Point& point1, const Point& point2) override;
+  void draw_lines(const std::vector<Point>& endpoints) override;
   void draw_dotted_line(const Point& start,
                         int length, bool vertical = true) override;
 
   void draw_rect(const Rect& rect) override;
   void fill_rect(const Rect& rect) override;
+  void fill_rects(const std::vector<Rect>& rects) override;
 
   Rect draw_text(const Point& point, const Font& font,
                  const std::string& text) override;
@@ -56,6 +64,18 @@ public:
 
   void copy_texture(const Texture& src,
                     const Rect& src_rect, const Rect& dest_rect) override;
+  void copy_texture(const Texture& src, const Rect& src_rect,
+                    const std::vector<Rect>& dest_rects) override;
+
+  std::unique_ptr<Texture> new_target_texture(int width,
+                                              int height) override;
+  std::unique_ptr<Texture> new_streaming_texture(int width,
+                                                 int height) override;
+  void update_texture(Texture& texture, const Rect& rect,
+                      const std::uint32_t* pixels) override;
+
+  void set_target(Texture& texture, bool clear = false) override;
+  void set_target() override;
 
   void set_clip_rect() override;
   void set_clip_rect(const Rect& rect) override;
@@ -65,8 +85,12 @@ public:
   SDL_Renderer* get_sdl_handle() { return m_renderer; }
 
 private:
+  const SDLFont& sdl_font(const Font& font) const;
+  const SDLTexture& sdl_texture(const Texture& texture) const;
+
   SDL_Renderer* m_renderer;
   SDL_Color m_draw_color;
+  std::unique_ptr<SDLTextCache> m_text_cache;
 };
 
 #endif
@@ -0,0 +1,138 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "video/sdl/sdl_text_cache.hpp"
+
+#include <algorithm>
+#include <vector>
+#include "utility/sdl/sdl_error.hpp"
+#include "video/sdl/sdl_font.hpp"
+#include "video/sdl/sdl_texture.hpp"
+
+namespace {
+  const SDL_Color text_color = { 255, 255, 255, 255 };
+}
+
+SDLTextCache::SDLTextCache(SDL_Renderer* renderer,
+                           std::size_t max_strings,
+                           std::size_t max_atlases)
+  : m_renderer(renderer),
+    m_max_strings(std::max<std::size_t>(max_strings, 1)),
+    m_max_atlases(std::max<std::size_t>(max_atlases, 1))
+{
+}
+
+SDLTextCache::~SDLTextCache()
+{
+}
+
+const SDLTextCache::GlyphAtlas&
+SDLTextCache::digit_atlas(const SDLFont& font)
+{
+  auto it = std::find_if(m_atlases.begin(), m_atlases.end(),
+                         [&font](const AtlasEntry& entry) {
+                           return entry.font_id == font.cache_id();
+                         });
+  if (it != m_atlases.end()) {
+    m_atlases.splice(m_atlases.begin(), m_atlases, it);
+    return m_atlases.front().atlas;
+  }
+
+  //render each digit separately and lay them out in a single row
+  std::vector<SDL_Surface*> glyphs;
+  GlyphAtlas atlas;
+  int width = 0, height = 0;
+  for (int i = 0; i < 10; ++i) {
+    char digit[] = { static_cast<char>('0' + i), '\0' };
+    SDL_Surface* glyph = TTF_RenderUTF8_Blended(font.get_sdl_handle(),
+                                                digit, text_color);
+    if (!glyph) {
+      for (auto s : glyphs)
+        SDL_FreeSurface(s);
+      throw TTFError("TTF_RenderUTF8_Blended");
+    }
+
+    glyphs.push_back(glyph);
+    atlas.digits[i] = SDL_Rect { width, 0, glyph->w, glyph->h };
+    width += glyph->w;
+    height = std::max(height, glyph->h);
+  }
+
+  SDL_Surface* surface
+    = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                     SDL_PIXELFORMAT_RGBA32);
+  if (surface) {
+    for (int i = 0; i < 10; ++i) {
+      SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(glyphs[i], NULL, surface, &atlas.digits[i]);
+    }
+  }
+  for (auto s : glyphs)
+    SDL_FreeSurface(s);
+  if (!surface)
+    throw SDLError("SDL_CreateRGBSurfaceWithFormat");
+
+  atlas.texture.reset(new SDLTexture(m_renderer, surface));
+  SDL_FreeSurface(surface);
+
+  m_atlases.push_front(AtlasEntry { font.cache_id(), std::move(atlas) });
+  if (m_atlases.size() > m_max_atlases)
+    m_atlases.pop_back();
+  return m_atlases.front().atlas;
+}
+
+const SDLTexture* SDLTextCache::string_texture(const SDLFont& font,
+                                               const std::string& text)
+{
+  Key key { font.cache_id(), text };
+  auto index_it = m_string_index.find(key);
+  if (index_it != m_string_index.end()) {
+    m_strings.splice(m_strings.begin(), m_strings, index_it->second);
+    return m_strings.front().texture.get();
+  }
+
+  if (text.empty())
+    return nullptr;
+
+  SDL_Surface* surface = TTF_RenderUTF8_Blended(font.get_sdl_handle(),
+                                                text.c_str(),
+                                                text_color);
+  if (!surface)
+    return nullptr;
+  std::unique_ptr<SDLTexture> texture(new SDLTexture(m_renderer, surface));
+  SDL_FreeSurface(surface);
+
+  m_strings.push_front(StringEntry { key, std::move(texture) });
+  m_string_index[std::move(key)] = m_strings.begin();
+
+  if (m_strings.size() > m_max_strings) {
+    m_string_index.erase(m_strings.back().key);
+    m_strings.pop_back();
+  }
+
+  return m_strings.front().texture.get();
+}
+
+void SDLTextCache::clear()
+{
+  m_string_index.clear();
+  m_strings.clear();
+  m_atlases.clear();
+}
@@ -0,0 +1,106 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_SDL_TEXT_CACHE_HPP
+#define NONNY_SDL_TEXT_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "SDL.h"
+
+class SDLFont;
+class SDLTexture;
+
+/*
+ * Keeps rendered text around between frames so that drawing text
+ * is a matter of copying textures. Digits, which make up every
+ * puzzle clue, are rendered once per font into a glyph atlas.
+ * Other strings are kept in a least-recently-used cache. All text
+ * is rendered in white; callers tint it with a color modulation.
+ */
+class SDLTextCache {
+public:
+  struct GlyphAtlas {
+    std::unique_ptr<SDLTexture> texture;
+    std::array<SDL_Rect, 10> digits; //source rectangles for 0-9
+  };
+
+  SDLTextCache(SDL_Renderer* renderer,
+               std::size_t max_strings = 512,
+               std::size_t max_atlases = 8);
+  ~SDLTextCache();
+
+  SDLTextCache(const SDLTextCache&) = delete;
+  SDLTextCache& operator=(const SDLTextCache&) = delete;
+
+  //get the digit atlas for the font, building it if necessary
+  const GlyphAtlas& digit_atlas(const SDLFont& font);
+
+  //get a texture containing the rendered text, or nullptr if the
+  //text produces no image (such as an empty string)
+  const SDLTexture* string_texture(const SDLFont& font,
+                                   const std::string& text);
+
+  void clear();
+
+private:
+  struct Key {
+    unsigned long font_id;
+    std::string text;
+
+    bool operator==(const Key& other) const {
+      return font_id == other.font_id && text == other.text;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return std::hash<std::string>()(key.text) ^ (key.font_id * 31);
+    }
+  };
+
+  struct StringEntry {
+    Key key;
+    std::unique_ptr<SDLTexture> texture;
+  };
+
+  struct AtlasEntry {
+    unsigned long font_id;
+    GlyphAtlas atlas;
+  };
+
+  typedef std::list<StringEntry> StringList;
+  typedef std::list<AtlasEntry> AtlasList;
+
+  SDL_Renderer* m_renderer;
+  std::size_t m_max_strings;
+  std::size_t m_max_atlases;
+
+  //most recently used entries are at the front
+  StringList m_strings;
+  std::unordered_map<Key, StringList::iterator, KeyHash> m_string_index;
+  AtlasList m_atlases;
+};
+
+#endif
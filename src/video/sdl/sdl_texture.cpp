@@ -21,12 +21,11 @@
 #include "video/sdl/sdl_texture.hpp"
 
 SDLTexture::SDLTexture(SDL_Renderer* renderer,
-                       int width, int height)
+                       int width, int height, int access)
 {
   m_texture = SDL_CreateTexture(renderer,
                                 SDL_PIXELFORMAT_RGBA8888,
-                                SDL_TEXTUREACCESS_TARGET,
-                                width, height);
+                                access, width, height);
   m_width = width;
   m_height = height;
 }
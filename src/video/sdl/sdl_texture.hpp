@@ -27,7 +27,8 @@
 class SDLTexture : public Texture {
 public:
   SDLTexture() { } //null texture
-  SDLTexture(SDL_Renderer* renderer, int width, int height);
+  SDLTexture(SDL_Renderer* renderer, int width, int height,
+             int access = SDL_TEXTUREACCESS_TARGET);
   SDLTexture(SDL_Renderer* renderer, SDL_Surface* surface);
 
   SDLTexture(const SDLTexture&) = delete;
@@ -154,6 +154,21 @@ void FileView::update(unsigned ticks, InputHandler& input)
   }
 }
 
+unsigned FileView::update_timeout() const
+{
+  if (m_file_selection.is_scrolling() || m_need_path_change)
+    return 0;
+
+  const FileSelectionPanel& panel
+    = dynamic_cast<const FileSelectionPanel&>(m_file_selection.main_panel());
+  if (panel.is_loading())
+    return 0;
+
+  if (m_filename_box->has_focus())
+    return m_filename_box->time_until_blink();
+  return no_update_timeout;
+}
+
 void FileView::draw(Renderer& renderer)
 {
   renderer.set_draw_color(background_color);
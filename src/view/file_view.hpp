@@ -56,6 +56,8 @@ public:
   void draw(Renderer& renderer) override;
   void resize(int width, int height) override;
 
+  unsigned update_timeout() const override;
+
 private:
   void load_resources();
 
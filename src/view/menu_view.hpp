@@ -43,6 +43,11 @@ public:
   void draw(Renderer& renderer) override;
   void resize(int width, int height) override;
 
+  unsigned update_timeout() const override {
+    return m_sliding || m_action != MenuAction::no_action
+      ? 0 : no_update_timeout;
+  }
+
 private:
   void load_resources();
   void start_slide();
@@ -41,6 +41,7 @@ public:
   void resize(int width, int height) override;
 
   bool is_transparent() const override { return true; }
+  unsigned update_timeout() const override { return no_update_timeout; }
 
 private:
   void load_resources();
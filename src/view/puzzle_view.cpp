@@ -30,14 +30,16 @@
 #include "SDL.h"
 #include "SDL_image.h"
 #include "color/color.hpp"
+#include "color/color_quantizer.hpp"
 #include "input/input_handler.hpp"
 #include "puzzle/puzzle_io.hpp"
+#include "puzzle/puzzle_pack.hpp"
 #include "puzzle/puzzle_progress.hpp"
 #include "settings/game_settings.hpp"
-#include "solver/solver.hpp"
 #include "ui/puzzle_info_panel.hpp"
 #include "ui/puzzle_panel.hpp"
 #include "ui/scrollbar.hpp"
+#include "utility/sdl/sdl_error.hpp"
 #include "utility/utility.hpp"
 #include "video/font.hpp"
 #include "video/renderer.hpp"
@@ -47,8 +49,9 @@
 
 namespace stdfs = std::experimental::filesystem;
 
-constexpr int info_pane_width = 256;
+constexpr int PuzzleView::info_pane_width;
 constexpr int info_pane_slide_speed = 1000;
+constexpr unsigned autosave_interval = 30000;
 const Color info_pane_background_color(123, 175, 212);
 
 PuzzleView::PuzzleView(ViewManager &vm)
@@ -134,17 +137,51 @@ PuzzleView &PuzzleView::operator=(PuzzleView &&pv) &
 
 void PuzzleView::load(const std::string &filename)
 {
-  std::ifstream file(filename);
-  if (!file.is_open())
+  if (file_type(filename) == PuzzleFormat::png)
   {
-    throw std::runtime_error("PuzzleView::load: "
-                             "could not open puzzle file " +
-                             filename);
+    // images are imported as a new, untitled puzzle to be edited
+    read_puzzle_png(filename, m_puzzle,
+                    m_mgr.game_settings().import_colors());
+    if (m_puzzle.width() == 0 || m_puzzle.height() == 0)
+      throw InvalidPuzzleFile("PuzzleView::load: image has a "
+                              "size of 0");
+
+    m_edit_mode = true;
+    setup_panels();
+    handle_color_change();
+    return;
   }
 
-  m_puzzle_filename = filename;
+  std::string pack_file, entry_name;
+  if (split_pack_path(filename, pack_file, entry_name))
+  {
+    PuzzlePack pack(pack_file);
+    auto entry = pack.find(entry_name);
+    if (entry == pack.end())
+    {
+      throw std::runtime_error("PuzzleView::load: "
+                               "could not find puzzle " +
+                               entry_name + " in " + pack_file);
+    }
+    pack.read(*entry, m_puzzle);
+  }
+  else
+  {
+    PuzzleFormat type = file_type(filename);
+    std::ifstream file(filename, type == PuzzleFormat::nbn
+                                     ? std::ios::in | std::ios::binary
+                                     : std::ios::in);
+    if (!file.is_open())
+    {
+      throw std::runtime_error("PuzzleView::load: "
+                               "could not open puzzle file " +
+                               filename);
+    }
+
+    read_puzzle(file, m_puzzle, type);
+  }
 
-  read_puzzle(file, m_puzzle, file_type(filename));
+  m_puzzle_filename = filename;
 
   // load puzzle progress
   std::string id = puzzle_id();
@@ -192,6 +229,8 @@ PuzzleFormat PuzzleView::file_type(const std::string &filename) const
     return PuzzleFormat::mk;
   else if (extension == ".nin")
     return PuzzleFormat::nin;
+  else if (extension == ".nbn")
+    return PuzzleFormat::nbn;
   else if (extension == ".png")
     return PuzzleFormat::png;
   else
@@ -258,6 +297,30 @@ void PuzzleView::save_progress()
   pp.clear_save_flag();
 }
 
+/*
+ * Periodically queue the current progress to be written in the
+ * background. The save flag is left alone, so the user is still asked
+ * to save before leaving the puzzle.
+ */
+void PuzzleView::autosave(unsigned ticks)
+{
+  if (m_edit_mode)
+    return;
+
+  m_autosave_time += ticks;
+  if (m_autosave_time < autosave_interval)
+    return;
+  m_autosave_time = 0;
+
+  if (!is_save_needed() || m_puzzle.revision() == m_autosave_revision)
+    return;
+  m_autosave_revision = m_puzzle.revision();
+
+  m_mgr.save_manager().queue_progress(m_puzzle, time(), false,
+                                      m_puzzle_filename,
+                                      puzzle_collection(), puzzle_id());
+}
+
 void PuzzleView::restart()
 {
   auto &ipanel = dynamic_cast<PuzzleInfoPanel &>(m_info_pane.main_panel());
@@ -305,14 +368,28 @@ void PuzzleView::save_puzzle(std::string filename)
       }
       else
       {
-        std::ofstream file(filename);
-
-        if (file.is_open())
-          m_puzzle_filename = filename;
-
         try
         {
-          write_puzzle(file, m_puzzle, file_type(filename));
+          std::string pack_file, entry_name;
+          if (split_pack_path(filename, pack_file, entry_name))
+          {
+            // packs are append-only, the new entry supersedes the old one
+            PuzzlePack pack(pack_file, true);
+            pack.append(entry_name, m_puzzle);
+            pack.commit();
+            m_puzzle_filename = filename;
+          }
+          else
+          {
+            std::ofstream file(filename, type == PuzzleFormat::nbn
+                                             ? std::ios::out | std::ios::binary
+                                             : std::ios::out);
+
+            if (file.is_open())
+              m_puzzle_filename = filename;
+
+            write_puzzle(file, m_puzzle, type);
+          }
 
           // wipe previous puzzle progress and store solution
           save_progress();
@@ -370,12 +447,8 @@ void PuzzleView::set_edit_mode()
   }
 }
 
-void PuzzleView::solve_and_edit()
+void PuzzleView::edit_solved_puzzle()
 {
-  m_puzzle.clear_all_cells();
-  Solver solver(m_puzzle);
-  solver();
-
   enable_editing();
 }
 
@@ -565,6 +638,8 @@ void PuzzleView::update(unsigned ticks, InputHandler &input)
     save_progress();
     m_mgr.schedule_action(ViewManager::Action::show_victory_screen);
   }
+  else
+    autosave(ticks);
 
   if (input.was_key_pressed(Keyboard::Key::escape))
     m_mgr.schedule_action(ViewManager::Action::open_menu);
@@ -654,6 +729,25 @@ void PuzzleView::update(unsigned ticks, InputHandler &input)
   }
 }
 
+unsigned PuzzleView::update_timeout() const
+{
+  if (m_info_pane.boundary().width() < info_pane_width)
+    return 0; // info pane still sliding in
+
+  if (m_main_panel.is_scrolling() || m_info_pane.is_scrolling())
+    return 0;
+
+  auto *ppanel = dynamic_cast<const PuzzlePanel *>(&m_main_panel.main_panel());
+  if (ppanel && ppanel->is_animating())
+    return 0;
+
+  // wake up when the displayed time changes
+  if (!m_edit_mode)
+    return 1000 - time() % 1000;
+
+  return no_update_timeout;
+}
+
 void PuzzleView::draw(Renderer &renderer)
 {
   m_main_panel.draw(renderer);
@@ -693,8 +787,126 @@ unsigned PuzzleView::time() const
   return ipanel.time();
 }
 
-void read_puzzle_png(const std::string &filename, Puzzle &puzzle)
+/*
+ * Import an image as a new puzzle. Transparent pixels become blank
+ * cells, as does the quantized color closest to white, provided it is
+ * reasonably close. Keeping white would collide with the palette's
+ * background entry and leave invisible filled cells.
+ */
+void read_puzzle_png(const std::string &filename, Puzzle &puzzle,
+                     int max_colors)
 {
+  const int alpha_threshold = 128;
+  const int background_threshold = 48;
+  const std::string symbols = "abcdefghijklmnopqrstuvwyz"
+                              "ABCDEFGHIJKLMNOPQRSTUVWYZ0123456789";
+  max_colors = std::min(max_colors, static_cast<int>(symbols.size()));
+
+  SDL_Surface *image = IMG_Load(filename.c_str());
+  if (!image)
+    throw IMGError("::read_puzzle_png: IMG_Load");
+  // the surface is freed (and unlocked) even if building the puzzle throws
+  std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>
+      surface(SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0),
+              &SDL_FreeSurface);
+  SDL_FreeSurface(image);
+  if (!surface)
+    throw SDLError("::read_puzzle_png: SDL_ConvertSurfaceFormat");
+
+  if (SDL_MUSTLOCK(surface.get()))
+    SDL_LockSurface(surface.get());
+
+  const int width = surface->w, height = surface->h;
+  const SDL_Surface *pixels = surface.get();
+  auto pixel = [pixels](int x, int y)
+  {
+    return static_cast<const Uint8 *>(pixels->pixels) + y * pixels->pitch + 4 * x;
+  };
+
+  // gather the color histogram
+  ColorQuantizer quantizer(max_colors);
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      const Uint8 *p = pixel(x, y);
+      if (p[3] >= alpha_threshold)
+        quantizer.add(p[0], p[1], p[2]);
+    }
+  }
+  quantizer.build();
+  const std::vector<Color> &colors = quantizer.palette();
+
+  int background = -1;
+  int best_distance = 3 * background_threshold * background_threshold;
+  for (int i = 0; i < static_cast<int>(colors.size()); ++i)
+  {
+    int dr = 255 - colors[i].red(), dg = 255 - colors[i].green(),
+        db = 255 - colors[i].blue();
+    int distance = dr * dr + dg * dg + db * db;
+    if (distance <= best_distance)
+    {
+      best_distance = distance;
+      background = i;
+    }
+  }
+
+  // reuse the standard color names where possible
+  ColorPalette palette;
+  ColorPalette named = ColorPalette::default_palette();
+  int next_symbol = 0;
+  for (int i = 0; i < static_cast<int>(colors.size()); ++i)
+  {
+    if (i == background || palette.find(colors[i]) != palette.end())
+      continue;
+
+    auto entry = named.find(colors[i]);
+    if (entry != named.end())
+      palette.add(entry->color, entry->name, entry->symbol);
+    else
+      palette.add(colors[i], "color" + std::to_string(next_symbol + 1),
+                  symbols[next_symbol]);
+    ++next_symbol;
+  }
+
+  // join each row's pixels into runs of one color, so every color is
+  // set in a single call and each line is only flagged once
+  std::vector<std::vector<Puzzle::Span>> spans(colors.size());
+  for (int y = 0; y < height; ++y)
+  {
+    int run_index = -1, run_begin = 0;
+    for (int x = 0; x <= width; ++x)
+    {
+      int index = -1;
+      if (x < width)
+      {
+        const Uint8 *p = pixel(x, y);
+        if (p[3] >= alpha_threshold)
+          index = quantizer.map(p[0], p[1], p[2]);
+        if (index == background)
+          index = -1;
+      }
+
+      if (index != run_index)
+      {
+        if (run_index >= 0)
+          spans[run_index].push_back({y, run_begin, x});
+        run_index = index;
+        run_begin = x;
+      }
+    }
+  }
+
+  puzzle = Puzzle(width, height, palette);
+  for (std::size_t i = 0; i < spans.size(); ++i)
+  {
+    if (!spans[i].empty())
+      puzzle.set_spans(spans[i], PuzzleCell::State::filled, colors[i]);
+  }
+  puzzle.update(true);
+
+  if (SDL_MUSTLOCK(surface.get()))
+    SDL_UnlockSurface(surface.get());
 }
 
 void write_puzzle_png(const std::string &filename, Puzzle &puzzle)
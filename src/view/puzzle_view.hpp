@@ -34,6 +34,9 @@
  */
 class PuzzleView : public View {
 public:
+  // Width of the info pane once it has slid in from the left
+  static constexpr int info_pane_width = 256;
+
   // Load a blank puzzle in edit mode
   PuzzleView(ViewManager& vm);
   PuzzleView(ViewManager& vm, int width, int height);
@@ -52,12 +55,16 @@ public:
   void draw(Renderer& renderer) override;
   void resize(int width, int height) override;
 
+  unsigned update_timeout() const override;
+
   void save_progress();
   void restart();
   void save_puzzle(std::string filename = "");
   void update_properties();
   void set_edit_mode();
-  void solve_and_edit();
+
+  // Switch to edit mode once the cells hold the solution (see SolveView)
+  void edit_solved_puzzle();
 
   bool is_editing_mode_active() const { return m_edit_mode; }
   bool is_save_needed() const;
@@ -77,6 +84,7 @@ private:
   void handle_color_change();
   void handle_tool_change();
   void save();
+  void autosave(unsigned ticks);
   void enable_editing();
   std::string puzzle_id() const;
   std::string puzzle_collection() const;
@@ -87,6 +95,8 @@ private:
   unsigned m_best_time = 0;
   bool m_ask_before_save = false;
   bool m_draw_tooltips = true;
+  unsigned m_autosave_time = 0;
+  unsigned long m_autosave_revision = 0;
 
   ScrollingPanel m_main_panel;
   ScrollingPanel m_info_pane;
@@ -102,7 +112,9 @@ private:
   std::unique_ptr<Texture> m_draw_texture;
 };
 
-void read_puzzle_png(const std::string& filename, Puzzle& puzzle);
+// Import an image, reducing it to at most max_colors colors
+void read_puzzle_png(const std::string& filename, Puzzle& puzzle,
+                     int max_colors);
 void write_puzzle_png(const std::string& filename, Puzzle& puzzle);
 
 #endif
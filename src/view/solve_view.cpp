@@ -0,0 +1,148 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#include "view/solve_view.hpp"
+
+#include <string>
+#include "input/input_handler.hpp"
+#include "puzzle/puzzle.hpp"
+#include "settings/game_settings.hpp"
+#include "ui/button.hpp"
+#include "utility/utility.hpp"
+#include "view/view_manager.hpp"
+
+constexpr int button_width = 150;
+constexpr int mbox_width = 320;
+constexpr unsigned solve_time_limit = 30000;
+constexpr unsigned text_refresh_interval = 100;
+
+SolveView::SolveView(ViewManager& vm, Puzzle& puzzle)
+  : View(vm), m_puzzle(puzzle)
+{
+  load_resources();
+
+  Puzzle copy(m_puzzle);
+  copy.clear_all_cells();
+  m_task.start(copy, solve_time_limit);
+
+  m_mbox = MessageBox(*m_control_font, "", mbox_width);
+  auto button = std::make_shared<Button>(*m_control_font, "Cancel");
+  button->register_callback([this]() { cancel(); });
+  button->resize(button_width, button->boundary().height());
+  button->give_focus();
+  m_mbox.add_control(button);
+
+  update_text();
+  resize(m_width, m_height);
+}
+
+void SolveView::update(unsigned ticks, InputHandler& input)
+{
+  if (m_finished)
+    return;
+
+  if (m_task.is_done()) {
+    finish();
+    return;
+  }
+
+  m_run_time += ticks;
+  update_text();
+
+  if (input.was_key_pressed(Keyboard::Key::escape))
+    cancel();
+
+  m_mbox.update(ticks, input);
+}
+
+void SolveView::draw(Renderer& renderer)
+{
+  m_mbox.draw(renderer);
+}
+
+void SolveView::resize(int width, int height)
+{
+  View::resize(width, height);
+
+  m_mbox.recalculate_size();
+  m_mbox.move(m_width / 2 - m_mbox.boundary().width() / 2,
+              m_height / 2 - m_mbox.boundary().height() / 2);
+  m_mbox.position_controls();
+}
+
+unsigned SolveView::update_timeout() const
+{
+  if (m_finished)
+    return no_update_timeout;
+  return text_refresh_interval;
+}
+
+void SolveView::load_resources()
+{
+  std::string file = m_mgr.game_settings().font_dir()
+    + m_mgr.game_settings().filesystem_separator() + "FreeSans.ttf";
+  m_control_font = m_mgr.video_system().new_font(file, 24);
+}
+
+void SolveView::update_text()
+{
+  SolverTask::Progress progress = m_task.progress();
+  int percent = 0;
+  if (progress.total_cells)
+    percent = 100 * progress.known_cells / progress.total_cells;
+
+  m_mbox.set_text("Solving puzzle... " + std::to_string(percent)
+                  + "%\nTime: " + time_to_string(m_run_time, true));
+}
+
+/*
+ * Apply the result of the finished task. The solution is copied into
+ * the puzzle here, on the main thread, in a single load_state call.
+ */
+void SolveView::finish()
+{
+  m_finished = true;
+  if (m_task.was_cancelled()) {
+    m_mgr.schedule_action(ViewManager::Action::close_menu);
+    return;
+  }
+
+  Solver& solver = m_task.solver();
+  if (solver.is_finished() && !solver.was_contradiction_found()) {
+    CompressedState state;
+    m_task.puzzle().copy_state(state);
+    m_puzzle.load_state(state);
+    m_mgr.schedule_action(ViewManager::Action::edit_solved_puzzle);
+  } else if (m_task.timed_out()) {
+    m_mgr.schedule_action(ViewManager::Action::solve_failed,
+                          "The solver could not finish within "
+                          + std::to_string(solve_time_limit / 1000)
+                          + " seconds.");
+  } else {
+    m_mgr.schedule_action(ViewManager::Action::solve_failed,
+                          "The puzzle has no solution.");
+  }
+}
+
+void SolveView::cancel()
+{
+  m_task.cancel();
+  finish();
+}
@@ -0,0 +1,65 @@
+/* Nonny -- Play and create nonogram puzzles.
+ * Copyright (C) 2017 Gregory Kikola.
+ *
+ * This file is part of Nonny.
+ *
+ * Nonny is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nonny is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nonny.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Written by Gregory Kikola <gkikola@gmail.com>. */
+
+#ifndef NONNY_SOLVE_VIEW_HPP
+#define NONNY_SOLVE_VIEW_HPP
+
+#include <memory>
+#include "solver/solver_task.hpp"
+#include "ui/message_box.hpp"
+#include "video/font.hpp"
+#include "view/view.hpp"
+
+class Puzzle;
+class ViewManager;
+
+/*
+ * Progress dialog shown while a puzzle is solved before editing. The
+ * solver runs in the background on a copy of the puzzle; the solution
+ * is copied into the puzzle only once it has been found. The user can
+ * cancel at any time, and the solver gives up after a time limit.
+ */
+class SolveView : public View {
+public:
+  SolveView(ViewManager& vm, Puzzle& puzzle);
+
+  void update(unsigned ticks, InputHandler& input) override;
+  void draw(Renderer& renderer) override;
+  void resize(int width, int height) override;
+
+  bool is_transparent() const override { return true; }
+  unsigned update_timeout() const override;
+
+private:
+  void load_resources();
+  void update_text();
+  void finish();
+  void cancel();
+
+  Puzzle& m_puzzle;
+  SolverTask m_task;
+  unsigned m_run_time = 0;
+  bool m_finished = false;
+
+  MessageBox m_mbox;
+  std::unique_ptr<Font> m_control_font;
+};
+
+#endif
@@ -54,6 +54,8 @@ public:
   void draw(Renderer& renderer) override;
   void resize(int width, int height) override;
 
+  unsigned update_timeout() const override { return no_update_timeout; }
+
 private:
   void load_resources();
 
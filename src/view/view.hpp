@@ -25,6 +25,9 @@ class InputHandler;
 class Renderer;
 class ViewManager;
 
+//returned by View::update_timeout when nothing will change without input
+constexpr unsigned no_update_timeout = static_cast<unsigned>(-1);
+
 /*
  * Base class representing a game screen. Each View corresponds to a
  * different game state. A View manages all the interface elements
@@ -43,6 +46,14 @@ public:
 
   virtual bool is_transparent() const { return false; }
 
+  /*
+   * Number of milliseconds the view can go without an update if no
+   * input arrives: 0 if it is animating, or no_update_timeout if it
+   * only changes in response to input. The game sleeps for this long
+   * between frames.
+   */
+  virtual unsigned update_timeout() const { return 0; }
+
 protected:
   ViewManager& m_mgr;
   int m_width = 0;
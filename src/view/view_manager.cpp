@@ -24,12 +24,14 @@
 #include <string>
 #include "input/input_handler.hpp"
 #include "settings/game_settings.hpp"
+#include "utility/profiler.hpp"
 #include "video/renderer.hpp"
 #include "view/analyze_view.hpp"
 #include "view/data_edit_view.hpp"
 #include "view/file_view.hpp"
 #include "view/menu_view.hpp"
 #include "view/puzzle_view.hpp"
+#include "view/solve_view.hpp"
 #include "view/victory_view.hpp"
 
 ViewManager::ViewManager(VideoSystem& vs, Renderer& renderer,
@@ -76,6 +78,8 @@ void ViewManager::pop()
 
 void ViewManager::update(unsigned ticks, InputHandler& input)
 {
+  ScopedTimer timer(Profiler::Section::view_update);
+
   if (m_action != Action::no_action) {
     if (m_mbox_open && m_action != Action::message_box) {
       m_mbox_open = false;
@@ -156,8 +160,12 @@ void ViewManager::update(unsigned ticks, InputHandler& input)
       pop(); //close file selector
 
       try {
-        push(std::make_shared<PuzzleView>(*this, m_action_arg));
-        m_puzzle_status = puzzle_play;
+        auto pview = std::make_shared<PuzzleView>(*this, m_action_arg);
+        push(pview);
+        if (pview->is_editing_mode_active())
+          m_puzzle_status = puzzle_edit; //imported image
+        else
+          m_puzzle_status = puzzle_play;
       } catch (const std::exception& e) {
         std::string err_msg = "Error loading puzzle:\n\n";
         err_msg += e.what();
@@ -204,15 +212,30 @@ void ViewManager::update(unsigned ticks, InputHandler& input)
       }
       break;
     case Action::solve_and_edit:
+      if (!m_views.empty()) {
+        auto pview = std::dynamic_pointer_cast<PuzzleView>(m_views.back());
+        if (pview)
+          push(std::make_shared<SolveView>(*this, pview->puzzle()));
+      }
+      break;
+    case Action::edit_solved_puzzle:
+      pop(); //close the solver dialog
       if (!m_views.empty()) {
         auto pview = std::dynamic_pointer_cast<PuzzleView>(m_views.back());
         if (pview) {
-          pview->solve_and_edit();
+          pview->edit_solved_puzzle();
           if (pview->is_editing_mode_active())
             m_puzzle_status = puzzle_edit;
         }
       }
       break;
+    case Action::solve_failed:
+      pop(); //close the solver dialog
+      message_box(m_action_arg, MessageBoxView::Type::okay,
+                  std::bind(&ViewManager::schedule_action,
+                            this, Action::close_message_box, ""),
+                  nullptr, nullptr);
+      break;
     case Action::quit_puzzle:
       if (!m_views.empty()
           && typeid(*m_views.back()) != typeid(VictoryView)
@@ -293,8 +316,19 @@ void ViewManager::update(unsigned ticks, InputHandler& input)
     m_views.back()->update(ticks, input);
 }
 
+unsigned ViewManager::update_timeout() const
+{
+  if (m_action != Action::no_action)
+    return 0;
+  if (m_views.empty())
+    return no_update_timeout;
+  return m_views.back()->update_timeout();
+}
+
 void ViewManager::draw(Renderer& renderer)
 {
+  ScopedTimer timer(Profiler::Section::view_draw);
+
   if (!m_views.empty()) {
     auto cur = m_views.end() - 1;
     while ((*cur)->is_transparent() && cur != m_views.begin())
@@ -53,7 +53,8 @@ public:
       analyze_puzzle, edit_puzzle, solve_and_edit, quit_puzzle,
       save_and_quit_puzzle, force_quit_puzzle, save_game,
       restart, show_victory_screen,
-      edit_puzzle_data, message_box, close_message_box };
+      edit_puzzle_data, message_box, close_message_box,
+      edit_solved_puzzle, solve_failed };
   inline void schedule_action(Action action, std::string argument = "");
 
   typedef std::function<void()> Callback;
@@ -69,6 +70,9 @@ public:
   void update(unsigned ticks, InputHandler& input);
   void draw(Renderer& renderer);
 
+  //how long the active view can wait for input (see View)
+  unsigned update_timeout() const;
+
   void refresh();
   void resize(int width, int height);
   int width() const { return m_width; }